@@ -0,0 +1,105 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Sprite sheet animator
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#include "Animator.h"
+#include "SimdKernels.h"
+
+void InitAnimator(Animator &animator, int capacity) {
+    animator.count = 0;
+    animator.capacity = capacity;
+    animator.timer.assign(capacity, 0.0f);
+    animator.frameTime.assign(capacity, 0.0f);
+    animator.frame.assign(capacity, 0);
+    animator.frameCount.assign(capacity, 0);
+    animator.mode.assign(capacity, ANIMATION_LOOP);
+    animator.direction.assign(capacity, 1);
+    animator.finished.assign(capacity, 0);
+    animator.frameWidth.assign(capacity, 0.0f);
+    animator.source.assign(capacity, (Rectangle){0});
+    animator.due.assign(capacity, 0);
+}
+
+int AddAnimation(Animator &animator) {
+    if (animator.count >= animator.capacity) {
+        return -1;
+    }
+    return animator.count++;
+}
+
+void RemoveAnimation(Animator &animator, int index) {
+    //move the last animation into the hole
+    int last = --animator.count;
+    animator.timer[index] = animator.timer[last];
+    animator.frameTime[index] = animator.frameTime[last];
+    animator.frame[index] = animator.frame[last];
+    animator.frameCount[index] = animator.frameCount[last];
+    animator.mode[index] = animator.mode[last];
+    animator.direction[index] = animator.direction[last];
+    animator.finished[index] = animator.finished[last];
+    animator.frameWidth[index] = animator.frameWidth[last];
+    animator.source[index] = animator.source[last];
+}
+
+void PlayAnimation(Animator &animator, int index, const AnimationClip &clip) {
+    animator.timer[index] = 0.0f;
+    animator.frameTime[index] = clip.frameTime;
+    animator.frame[index] = 0;
+    animator.frameCount[index] = clip.frameCount;
+    animator.mode[index] = clip.mode;
+    animator.direction[index] = 1;
+    animator.finished[index] = 0;
+    animator.frameWidth[index] = clip.frameWidth;
+    animator.source[index] = (Rectangle){0, 0, clip.frameWidth, clip.frameHeight};
+}
+
+//next frame of a due animation, by its mode
+static void StepFrame(Animator &animator, int i) {
+    int frame = animator.frame[i];
+    const int last = animator.frameCount[i] - 1;
+    switch (animator.mode[i]) {
+        case ANIMATION_ONCE:
+            if (frame < last) {
+                frame++;
+            } else {
+                animator.finished[i] = 1;
+            }
+            break;
+        case ANIMATION_PING_PONG:
+            //turn around at either end
+            if (frame + animator.direction[i] > last || frame + animator.direction[i] < 0) {
+                animator.direction[i] = -animator.direction[i];
+            }
+            if (last > 0) {
+                frame += animator.direction[i];
+            }
+            break;
+        default:
+            frame = frame < last ? frame + 1 : 0;
+            break;
+    }
+    animator.frame[i] = frame;
+    animator.source[i].x = frame * animator.frameWidth[i];
+}
+
+void AdvanceAnimations(Animator &animator, float dT) {
+    //all timers in one pass, only the due ones step (a few percent of them per tick)
+    int due = StepAnimationTimers(animator.timer.data(), animator.frameTime.data(), animator.count, dT, animator.due.data());
+    for (int i = 0; i < due; i++) {
+        StepFrame(animator, animator.due[i]);
+    }
+}
+
+AnimationClip SheetClip(Texture2D sheet, int frameCount, float frameTime, AnimationMode mode) {
+    AnimationClip clip;
+    clip.frameCount = frameCount;
+    clip.frameTime = frameTime;
+    clip.mode = mode;
+    clip.frameWidth = static_cast<float>(sheet.width) / frameCount;
+    clip.frameHeight = static_cast<float>(sheet.height);
+    return clip;
+}
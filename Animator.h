@@ -0,0 +1,73 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Sprite sheet animator
+*
+*   Frame animation for every sprite sheet the game plays (Mochi, drones, impacts), kept
+*   one array per property like the entity stores. One pass steps all timers with a SIMD
+*   kernel, only the animations whose frame is due then take their mode's frame step and
+*   get their source rectangle refreshed, so drawing reads it instead of working it out.
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#ifndef MOCHI_ANIMATOR_H
+#define MOCHI_ANIMATOR_H
+
+#include <vector>
+#include "raylib.h"
+
+//what happens after the last frame
+enum AnimationMode {
+    //back to the first frame
+    ANIMATION_LOOP,
+    //stay on the last frame and report it finished
+    ANIMATION_ONCE,
+    //play backwards to the first frame, then forwards again
+    ANIMATION_PING_PONG
+};
+
+//how one sprite sheet animates, frames sit side by side
+struct AnimationClip {
+    int frameCount;
+    //seconds per frame
+    float frameTime;
+    AnimationMode mode;
+    float frameWidth;
+    float frameHeight;
+};
+
+//Playing animations, one array per property. Owners that swap-remove their entities
+//(EnemyStore) keep their animations at the same index and remove them alongside
+struct Animator {
+    int count;
+    int capacity;
+    std::vector<float> timer;
+    std::vector<float> frameTime;
+    std::vector<int> frame;
+    std::vector<int> frameCount;
+    std::vector<int> mode;
+    //+1 | -1, the way a ping-pong animation is going
+    std::vector<int> direction;
+    //one-shot animation past its last frame's time
+    std::vector<char> finished;
+    std::vector<float> frameWidth;
+    //current frame's rectangle on the sheet, ready to draw
+    std::vector<Rectangle> source;
+    //indices of the animations whose frame is due, scratch
+    std::vector<int> due;
+};
+
+//sized once, add returns the new index or -1 when full (play a clip on it before use)
+void InitAnimator(Animator &animator, int capacity);
+int AddAnimation(Animator &animator);
+void RemoveAnimation(Animator &animator, int index);
+//start clip on animation index from its first frame
+void PlayAnimation(Animator &animator, int index, const AnimationClip &clip);
+//advance every animation by dT
+void AdvanceAnimations(Animator &animator, float dT);
+
+//clip of a sheet holding frameCount frames
+AnimationClip SheetClip(Texture2D sheet, int frameCount, float frameTime, AnimationMode mode);
+
+#endif
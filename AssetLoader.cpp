@@ -0,0 +1,176 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Asset loader
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#include <algorithm>
+#include <cstring>
+#include "AssetLoader.h"
+#include "Trace.h"
+
+const char *soundFiles[SOUND_COUNT] = {
+    "sfx/jump.wav",
+    "sfx/impact.wav",
+    "sfx/eat.wav",
+    "sfx/alarm.wav",
+    "sfx/angry.wav",
+    "sfx/meow.wav"
+};
+
+const char *musicFiles[MUSIC_COUNT] = {
+    "sfx/menu.ogg",
+    "sfx/soundtrack.ogg"
+};
+
+//take jobs until none are left, CPU-side decode only
+static void AssetWorker(AssetLoader *loader) {
+    for (;;) {
+        int job = loader->nextJob.fetch_add(1);
+        if (job >= assetJobCount) {
+            return;
+        }
+
+        TraceClock::time_point start = TraceClock::now();
+        if (job < SPRITE_COUNT) {
+            loader->images[job] = LoadImage(spriteFiles[job]);
+            TraceComplete(spriteFiles[job], "asset", start, TraceClock::now());
+        } else {
+            int sound = job - SPRITE_COUNT;
+            loader->waves[sound] = LoadWave(soundFiles[sound]);
+            TraceComplete(soundFiles[sound], "asset", start, TraceClock::now());
+        }
+        //publishes the decoded slot to the main thread
+        loader->finishedJobs.fetch_add(1);
+    }
+}
+
+bool AssetPackComplete(const AssetPack &pack) {
+    const AssetPackEntry *sprites = FindAssetPackEntry(pack, packAtlasSprites, PACK_BLOB);
+    if (!FindAssetPackEntry(pack, packAtlasImage, PACK_IMAGE) || !sprites ||
+        sprites->size != sizeof(Rectangle) * (SPRITE_COUNT + 1)) {
+        return false;
+    }
+    for (int i = 0; i < SOUND_COUNT; i++) {
+        if (!FindAssetPackEntry(pack, soundFiles[i], PACK_WAVE)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void StartAssetLoader(AssetLoader &loader, const AssetPack *pack, int workerCount) {
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        loader.images[i] = (Image){0};
+    }
+    for (int i = 0; i < SOUND_COUNT; i++) {
+        loader.waves[i] = (Wave){0};
+    }
+    loader.nextJob = 0;
+    loader.finishedJobs = 0;
+    loader.finished = false;
+    loader.pack = nullptr;
+
+    //nothing to decode, FinishAssetLoader uploads from the pack
+    if (pack && AssetPackComplete(*pack)) {
+        loader.pack = pack;
+        loader.nextJob = assetJobCount;
+        loader.finishedJobs = assetJobCount;
+        return;
+    }
+    if (pack) {
+        TraceLog(LOG_WARNING, "PACK: atlas or sounds missing, decoding the loose files");
+    }
+
+    //leave a core for the main thread
+    if (workerCount <= 0) {
+        workerCount = (int)std::thread::hardware_concurrency() - 1;
+    }
+    workerCount = std::max(1, std::min(workerCount, maxAssetWorkers));
+    for (int i = 0; i < workerCount; i++) {
+        loader.workers.emplace_back(AssetWorker, &loader);
+    }
+}
+
+float AssetLoaderProgress(const AssetLoader &loader) {
+    return (float)loader.finishedJobs.load() / assetJobCount;
+}
+
+static void JoinAssetWorkers(AssetLoader &loader) {
+    for (std::thread &worker : loader.workers) {
+        worker.join();
+    }
+    loader.workers.clear();
+}
+
+//upload the baked atlas and the PCM sounds straight from the mapping
+static void FinishFromAssetPack(const AssetPack &pack, TextureAtlas &atlas, Sound sounds[SOUND_COUNT]) {
+    //sprite rectangles, then the white block
+    const Rectangle *rects = reinterpret_cast<const Rectangle *>(AssetPackData(pack, *FindAssetPackEntry(pack, packAtlasSprites, PACK_BLOB)));
+    memcpy(atlas.sprites, rects, sizeof(atlas.sprites));
+    atlas.solid = rects[SPRITE_COUNT];
+    if (!UploadTextureAtlas(atlas, AssetPackImage(pack, *FindAssetPackEntry(pack, packAtlasImage, PACK_IMAGE)))) {
+        TraceLog(LOG_WARNING, "ATLAS: packed atlas did not upload, textures will not draw");
+    }
+
+    for (int i = 0; i < SOUND_COUNT; i++) {
+        TraceClock::time_point start = TraceClock::now();
+        sounds[i] = LoadSoundFromWave(AssetPackWave(pack, *FindAssetPackEntry(pack, soundFiles[i], PACK_WAVE)));
+        TraceComplete(soundFiles[i], "sound upload", start, TraceClock::now());
+    }
+}
+
+bool FinishAssetLoader(AssetLoader &loader, TextureAtlas &atlas, Sound sounds[SOUND_COUNT]) {
+    if (loader.finished) {
+        return true;
+    }
+    if (loader.finishedJobs.load() < assetJobCount) {
+        return false;
+    }
+    if (loader.pack) {
+        FinishFromAssetPack(*loader.pack, atlas, sounds);
+        loader.finished = true;
+        return true;
+    }
+    //every job is taken, the workers are on their way out
+    JoinAssetWorkers(loader);
+
+    //GPU upload
+    if (!BuildTextureAtlas(atlas, loader.images)) {
+        TraceLog(LOG_WARNING, "ATLAS: sprites missing, textures will not draw");
+    }
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        UnloadImage(loader.images[i]);
+        loader.images[i] = (Image){0};
+    }
+
+    //audio buffers
+    for (int i = 0; i < SOUND_COUNT; i++) {
+        TraceClock::time_point start = TraceClock::now();
+        sounds[i] = LoadSoundFromWave(loader.waves[i]);
+        UnloadWave(loader.waves[i]);
+        loader.waves[i] = (Wave){0};
+        TraceComplete(soundFiles[i], "sound upload", start, TraceClock::now());
+    }
+
+    loader.finished = true;
+    return true;
+}
+
+void StopAssetLoader(AssetLoader &loader) {
+    loader.nextJob = assetJobCount;
+    JoinAssetWorkers(loader);
+    if (loader.finished) {
+        return;
+    }
+    //unused decodes (unloading an empty image | wave does nothing)
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        UnloadImage(loader.images[i]);
+    }
+    for (int i = 0; i < SOUND_COUNT; i++) {
+        UnloadWave(loader.waves[i]);
+    }
+    loader.finished = true;
+}
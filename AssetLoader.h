@@ -0,0 +1,83 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Asset loader
+*
+*   Decodes every sprite sheet (LoadImage) and sound effect (LoadWave) on a small pool of
+*   worker threads while the intro is already on screen. Only the work that needs the
+*   window or the audio device, packing and uploading the atlas and creating the sounds,
+*   runs on the main thread, once, when the last decode is done. With an asset pack there
+*   is nothing to decode: no workers start and the atlas and sounds are uploaded straight
+*   from the mapped pack.
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#ifndef MOCHI_ASSET_LOADER_H
+#define MOCHI_ASSET_LOADER_H
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "raylib.h"
+#include "AssetPack.h"
+#include "Atlas.h"
+
+//every sound effect
+enum SoundId {
+    SOUND_JUMP,
+    SOUND_IMPACT,
+    SOUND_EAT,
+    SOUND_ALARM,
+    SOUND_ANGRY,
+    SOUND_MEOW,
+    SOUND_COUNT
+};
+
+//source file of each sound, indexed by SoundId
+extern const char *soundFiles[SOUND_COUNT];
+
+//streamed music
+enum MusicId {
+    MUSIC_MENU,
+    MUSIC_SOUNDTRACK,
+    MUSIC_COUNT
+};
+
+//source file of each music stream, indexed by MusicId
+extern const char *musicFiles[MUSIC_COUNT];
+
+//decode jobs, every sprite sheet then every sound
+const int assetJobCount = SPRITE_COUNT + SOUND_COUNT;
+//most decode threads, the files are small and few
+const int maxAssetWorkers = 4;
+
+struct AssetLoader {
+    //decoded data, each slot written by one worker and read only after finishedJobs says so
+    Image images[SPRITE_COUNT];
+    Wave waves[SOUND_COUNT];
+    //next job a worker takes | jobs done
+    std::atomic<int> nextJob;
+    std::atomic<int> finishedJobs;
+    std::vector<std::thread> workers;
+    //pack everything is uploaded from instead, null when decoding the loose files
+    const AssetPack *pack;
+    //atlas and sounds created, decoded data freed
+    bool finished;
+};
+
+//true when pack holds the baked atlas and every sound
+bool AssetPackComplete(const AssetPack &pack);
+//start decoding on workerCount threads, 0 picks one per spare core (up to maxAssetWorkers).
+//A complete pack (kept open until FinishAssetLoader) replaces the decodes
+void StartAssetLoader(AssetLoader &loader, const AssetPack *pack = nullptr, int workerCount = 0);
+//share of the decodes done (0..1), for a progress bar
+float AssetLoaderProgress(const AssetLoader &loader);
+//main thread, every frame until it returns true: once all decodes are done, builds the
+//atlas and the sounds and frees the decoded data. Never blocks
+bool FinishAssetLoader(AssetLoader &loader, TextureAtlas &atlas, Sound sounds[SOUND_COUNT]);
+//stop handing out jobs, wait for the workers and free whatever was decoded but not used.
+//Safe at any point, e.g. when the window closes mid-load
+void StopAssetLoader(AssetLoader &loader);
+
+#endif
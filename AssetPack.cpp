@@ -0,0 +1,148 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Asset pack
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#include <cstring>
+#include "AssetPack.h"
+#include "Trace.h"
+
+static_assert(sizeof(AssetPackEntry) == 128, "asset pack index entries are 128 bytes");
+
+static const AssetPack *activePack = nullptr;
+
+//every entry inside the file and sized right for its kind
+static bool CheckPackIndex(const AssetPack &pack) {
+    for (int i = 0; i < pack.entryCount; i++) {
+        const AssetPackEntry &entry = pack.entries[i];
+        if (memchr(entry.name, 0, sizeof(entry.name)) == nullptr) {
+            return false;
+        }
+        if (entry.kind == PACK_SOURCE) {
+            continue;
+        }
+        if (entry.offset > pack.file.size || entry.size > pack.file.size - entry.offset) {
+            return false;
+        }
+        if (entry.kind == PACK_IMAGE && entry.size != (uint64_t)entry.params[0] * entry.params[1] * 4) {
+            return false;
+        }
+        if (entry.kind == PACK_WAVE && entry.size != (uint64_t)entry.params[0] * entry.params[3] * (entry.params[2] / 8)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//a loose file that still exists but is not what the pack was baked from
+static const AssetPackEntry *FindStaleSource(const AssetPack &pack) {
+    for (int i = 0; i < pack.entryCount; i++) {
+        const AssetPackEntry &entry = pack.entries[i];
+        if (entry.kind != PACK_SOURCE || !FileExists(entry.name)) {
+            continue;
+        }
+        if (GetFileModTime(entry.name) != entry.sourceTime || GetFileLength(entry.name) != entry.sourceSize) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool OpenAssetPack(AssetPack &pack, const char *fileName) {
+    TraceClock::time_point start = TraceClock::now();
+    pack = AssetPack{};
+    if (!OpenMappedFile(pack.file, fileName)) {
+        return false;
+    }
+
+    const AssetPackHeader *header = reinterpret_cast<const AssetPackHeader *>(pack.file.data);
+    bool valid = pack.file.size >= sizeof(AssetPackHeader) &&
+                 memcmp(header->magic, assetPackMagic, sizeof(assetPackMagic)) == 0 &&
+                 header->version == assetPackVersion &&
+                 header->entryCount <= (pack.file.size - sizeof(AssetPackHeader)) / sizeof(AssetPackEntry);
+    if (valid) {
+        pack.entries = reinterpret_cast<const AssetPackEntry *>(pack.file.data + sizeof(AssetPackHeader));
+        pack.entryCount = (int)header->entryCount;
+        valid = CheckPackIndex(pack);
+    }
+    if (!valid) {
+        TraceLog(LOG_WARNING, "PACK: %s is damaged or from another version, using the loose files", fileName);
+        CloseAssetPack(pack);
+        return false;
+    }
+
+    const AssetPackEntry *stale = FindStaleSource(pack);
+    if (stale) {
+        TraceLog(LOG_WARNING, "PACK: %s changed since %s was baked (make pack), using the loose files", stale->name, fileName);
+        CloseAssetPack(pack);
+        return false;
+    }
+
+    TraceComplete(fileName, "asset", start, TraceClock::now());
+    return true;
+}
+
+void CloseAssetPack(AssetPack &pack) {
+    if (activePack == &pack) {
+        activePack = nullptr;
+    }
+    CloseMappedFile(pack.file);
+    pack = AssetPack{};
+}
+
+const AssetPackEntry *FindAssetPackEntry(const AssetPack &pack, const char *name, AssetPackKind kind) {
+    for (int i = 0; i < pack.entryCount; i++) {
+        if (pack.entries[i].kind == (uint32_t)kind && strcmp(pack.entries[i].name, name) == 0) {
+            return &pack.entries[i];
+        }
+    }
+    return nullptr;
+}
+
+const unsigned char *AssetPackData(const AssetPack &pack, const AssetPackEntry &entry) {
+    return pack.file.data + entry.offset;
+}
+
+Image AssetPackImage(const AssetPack &pack, const AssetPackEntry &entry) {
+    Image image = {0};
+    //raylib takes non-const data, uploads only read it
+    image.data = const_cast<unsigned char *>(AssetPackData(pack, entry));
+    image.width = (int)entry.params[0];
+    image.height = (int)entry.params[1];
+    image.mipmaps = 1;
+    image.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+    return image;
+}
+
+Wave AssetPackWave(const AssetPack &pack, const AssetPackEntry &entry) {
+    Wave wave = {0};
+    wave.frameCount = entry.params[0];
+    wave.sampleRate = entry.params[1];
+    wave.sampleSize = entry.params[2];
+    wave.channels = entry.params[3];
+    wave.data = const_cast<unsigned char *>(AssetPackData(pack, entry));
+    return wave;
+}
+
+void SetActiveAssetPack(const AssetPack *pack) {
+    activePack = pack;
+}
+
+const AssetPack *GetActiveAssetPack() {
+    return activePack;
+}
+
+bool FindPackedImage(const char *fileName, Image &image) {
+    if (!activePack) {
+        return false;
+    }
+    const AssetPackEntry *entry = FindAssetPackEntry(*activePack, fileName, PACK_IMAGE);
+    if (!entry) {
+        return false;
+    }
+    image = AssetPackImage(*activePack, *entry);
+    return true;
+}
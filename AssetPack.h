@@ -0,0 +1,91 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Asset pack
+*
+*   One file (baked by tools/PackAssets, `make pack`) holding every asset already decoded:
+*   the packed texture atlas and each sprite sheet as RGBA pixels, the sound effects as PCM
+*   samples and the music files as they are. The game maps it and hands views into the
+*   mapping straight to the GPU | audio uploads, so startup reads one file and decodes
+*   nothing. The pack also records the size and time of every loose file it was baked
+*   from; when one of them changed the pack counts as stale and the loose files are used.
+*
+*   The layout is the baking machine's (byte order, struct padding), bake on the target.
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#ifndef MOCHI_ASSET_PACK_H
+#define MOCHI_ASSET_PACK_H
+
+#include <cstdint>
+#include "raylib.h"
+#include "MappedFile.h"
+
+//next to the game, like textures/ and sfx/
+const char *const assetPackFile = "assets.pak";
+const char assetPackMagic[8] = {'M', 'O', 'C', 'H', 'I', 'P', 'A', 'K'};
+const uint32_t assetPackVersion = 1;
+//entry data offsets are multiples of this
+const int assetPackAlignment = 64;
+
+//names of the atlas entries (the other entries are named after their loose file)
+const char *const packAtlasImage = "atlas";
+const char *const packAtlasSprites = "atlas.sprites";
+
+enum AssetPackKind {
+    //loose file the pack was baked from, no data (staleness check only)
+    PACK_SOURCE,
+    //RGBA8 pixels, params: width, height
+    PACK_IMAGE,
+    //PCM samples, params: frameCount, sampleRate, sampleSize, channels
+    PACK_WAVE,
+    //bytes as they are
+    PACK_BLOB
+};
+
+struct AssetPackHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t entryCount;
+};
+
+//index entry, the index follows the header
+struct AssetPackEntry {
+    char name[64];
+    uint32_t kind;
+    uint32_t params[4];
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t size;
+    //PACK_SOURCE: loose file modification time | length when baked
+    int64_t sourceTime;
+    int64_t sourceSize;
+    uint64_t padding;
+};
+
+struct AssetPack {
+    MappedFile file;
+    const AssetPackEntry *entries;
+    int entryCount;
+};
+
+//map and check a pack, false (pack closed) when it is missing, damaged, from another
+//version or stale
+bool OpenAssetPack(AssetPack &pack, const char *fileName);
+void CloseAssetPack(AssetPack &pack);
+
+//entry of kind called name, null when there is none
+const AssetPackEntry *FindAssetPackEntry(const AssetPack &pack, const char *name, AssetPackKind kind);
+const unsigned char *AssetPackData(const AssetPack &pack, const AssetPackEntry &entry);
+//views into the mapping, valid while the pack is open, never unload them
+Image AssetPackImage(const AssetPack &pack, const AssetPackEntry &entry);
+Wave AssetPackWave(const AssetPack &pack, const AssetPackEntry &entry);
+
+//pack that asset loads look in before the loose files, null when none is open
+void SetActiveAssetPack(const AssetPack *pack);
+const AssetPack *GetActiveAssetPack();
+//sprite sheet fileName from the active pack as a view, false when it is not packed
+bool FindPackedImage(const char *fileName, Image &image);
+
+#endif
@@ -0,0 +1,164 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Texture atlas
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#include <algorithm>
+#include <cstring>
+#include "Atlas.h"
+#include "Trace.h"
+
+const char *spriteFiles[SPRITE_COUNT] = {
+    "textures/background.png",
+    "textures/foreground.png",
+    "textures/mochi_intro.png",
+    "textures/mochi_running.png",
+    "textures/mochi_jump.png",
+    "textures/mochi_health.png",
+    "textures/health.png",
+    "textures/impact.png",
+    "textures/drone1.png",
+    "textures/drone2.png",
+    "textures/drone3.png",
+    "textures/drone4.png"
+};
+
+//atlas width, height grows to fit (power of two)
+const int atlasWidth = 1024;
+//empty pixels around each sprite so neighbours never bleed into a frame
+const int atlasPadding = 2;
+//white block at the top left, sampled from its middle so filtering stays inside
+const int atlasSolidSize = 4;
+
+//sprite rectangles of the last built atlas, for AtlasSpriteSize
+static Rectangle builtSprites[SPRITE_COUNT];
+
+//shelf packer, tallest sprites first, returns the used height
+static int PackSprites(const Image images[SPRITE_COUNT], Rectangle sprites[SPRITE_COUNT]) {
+    int order[SPRITE_COUNT];
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        order[i] = i;
+    }
+    std::sort(order, order + SPRITE_COUNT, [images](int a, int b) { return images[a].height > images[b].height; });
+
+    //first shelf starts after the white block
+    int shelfX = atlasSolidSize + atlasPadding * 2;
+    int shelfY = 0;
+    int shelfHeight = atlasSolidSize + atlasPadding * 2;
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        const Image &image = images[order[i]];
+        int width = image.width + atlasPadding * 2;
+        int height = image.height + atlasPadding * 2;
+
+        //start a new shelf when this row is full
+        if (shelfX + width > atlasWidth) {
+            shelfY += shelfHeight;
+            shelfX = 0;
+            shelfHeight = 0;
+        }
+        sprites[order[i]] = (Rectangle){(float)(shelfX + atlasPadding), (float)(shelfY + atlasPadding), (float)image.width, (float)image.height};
+        shelfX += width;
+        shelfHeight = std::max(shelfHeight, height);
+    }
+    return shelfY + shelfHeight;
+}
+
+Image BakeTextureAtlas(TextureAtlas &atlas, const Image images[SPRITE_COUNT]) {
+    TraceClock::time_point start = TraceClock::now();
+
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        if (images[i].data == nullptr || images[i].width > atlasWidth - atlasPadding * 2) {
+            TraceLog(LOG_WARNING, "ATLAS: cannot pack %s", spriteFiles[i]);
+            return (Image){0};
+        }
+    }
+
+    int usedHeight = PackSprites(images, atlas.sprites);
+    int atlasHeight = 1;
+    while (atlasHeight < usedHeight) {
+        atlasHeight *= 2;
+    }
+
+    //copy every sheet into place on the CPU
+    Image atlasImage = GenImageColor(atlasWidth, atlasHeight, BLANK);
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        Rectangle source = {0, 0, (float)images[i].width, (float)images[i].height};
+        ImageDraw(&atlasImage, images[i], source, atlas.sprites[i], WHITE);
+    }
+    ImageDrawRectangle(&atlasImage, atlasPadding, atlasPadding, atlasSolidSize, atlasSolidSize, WHITE);
+    atlas.solid = (Rectangle){(float)atlasPadding + 1, (float)atlasPadding + 1, (float)atlasSolidSize - 2, (float)atlasSolidSize - 2};
+
+    TraceComplete("texture atlas", "asset", start, TraceClock::now());
+    return atlasImage;
+}
+
+bool UploadTextureAtlas(TextureAtlas &atlas, Image atlasImage) {
+    if (atlasImage.data == nullptr) {
+        return false;
+    }
+    TraceClock::time_point start = TraceClock::now();
+    atlas.texture = LoadTextureFromImage(atlasImage);
+    memcpy(builtSprites, atlas.sprites, sizeof(builtSprites));
+    TraceComplete("texture atlas", "upload", start, TraceClock::now());
+    return atlas.texture.id != 0;
+}
+
+bool BuildTextureAtlas(TextureAtlas &atlas, const Image images[SPRITE_COUNT]) {
+    Image atlasImage = BakeTextureAtlas(atlas, images);
+    bool built = UploadTextureAtlas(atlas, atlasImage);
+    UnloadImage(atlasImage);
+    return built;
+}
+
+bool LoadTextureAtlas(TextureAtlas &atlas) {
+    Image images[SPRITE_COUNT];
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        TraceClock::time_point start = TraceClock::now();
+        images[i] = LoadImage(spriteFiles[i]);
+        TraceComplete(spriteFiles[i], "asset", start, TraceClock::now());
+    }
+
+    bool built = BuildTextureAtlas(atlas, images);
+
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        UnloadImage(images[i]);
+    }
+    return built;
+}
+
+void UnloadTextureAtlas(TextureAtlas &atlas) {
+    UnloadTexture(atlas.texture);
+    atlas.texture = (Texture2D){0};
+}
+
+Texture2D AtlasSpriteSize(const char *fileName) {
+    Texture2D texture = {0};
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        if (strcmp(spriteFiles[i], fileName) == 0) {
+            texture.width = (int)builtSprites[i].width;
+            texture.height = (int)builtSprites[i].height;
+            texture.mipmaps = 1;
+            break;
+        }
+    }
+    return texture;
+}
+
+void DrawSprite(const TextureAtlas &atlas, SpriteId sprite, Rectangle source, Rectangle dest, Color tint) {
+    const Rectangle &origin = atlas.sprites[sprite];
+    source.x += origin.x;
+    source.y += origin.y;
+    DrawTexturePro(atlas.texture, source, dest, (Vector2){0, 0}, 0.0f, tint);
+}
+
+void DrawSpriteEx(const TextureAtlas &atlas, SpriteId sprite, Vector2 pos, float scale, Color tint) {
+    const Rectangle &rect = atlas.sprites[sprite];
+    DrawTexturePro(atlas.texture, rect, (Rectangle){pos.x, pos.y, rect.width * scale, rect.height * scale}, (Vector2){0, 0}, 0.0f, tint);
+}
+
+void DrawAtlasRectangle(const TextureAtlas &atlas, Rectangle dest, Color color) {
+    DrawTexturePro(atlas.texture, atlas.solid, dest, (Vector2){0, 0}, 0.0f, color);
+}
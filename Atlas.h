@@ -0,0 +1,67 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Texture atlas
+*
+*   Packs every sprite sheet into one texture at startup with a lookup table of
+*   sub-rectangles, so sprite draws never switch textures and raylib keeps one batch.
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#ifndef MOCHI_ATLAS_H
+#define MOCHI_ATLAS_H
+
+#include "raylib.h"
+
+//every sprite sheet in the atlas
+enum SpriteId {
+    SPRITE_BACKGROUND,
+    SPRITE_FOREGROUND,
+    SPRITE_MOCHI_INTRO,
+    SPRITE_MOCHI_RUNNING,
+    SPRITE_MOCHI_JUMP,
+    SPRITE_MOCHI_HEALTH,
+    SPRITE_HEALTH_PICKUP,
+    SPRITE_IMPACT,
+    SPRITE_DRONE1,
+    SPRITE_DRONE2,
+    SPRITE_DRONE3,
+    SPRITE_DRONE4,
+    SPRITE_COUNT
+};
+
+//source file of each sprite, indexed by SpriteId
+extern const char *spriteFiles[SPRITE_COUNT];
+
+//one texture plus where each sprite sheet sits inside it
+struct TextureAtlas {
+    Texture2D texture;
+    Rectangle sprites[SPRITE_COUNT];
+    //plain white block, tinted for solid rectangles that stay in the sprite batch
+    Rectangle solid;
+};
+
+//pack already decoded images (indexed by SpriteId) into one image and fill in the
+//rectangles, CPU only (tools/PackAssets bakes it ahead of time). Empty image on failure
+Image BakeTextureAtlas(TextureAtlas &atlas, const Image images[SPRITE_COUNT]);
+//upload a baked atlas image, the rectangles must already be set, the image stays the caller's
+bool UploadTextureAtlas(TextureAtlas &atlas, Image atlasImage);
+//bake and upload
+bool BuildTextureAtlas(TextureAtlas &atlas, const Image images[SPRITE_COUNT]);
+//decode every sprite file, then build
+bool LoadTextureAtlas(TextureAtlas &atlas);
+void UnloadTextureAtlas(TextureAtlas &atlas);
+
+//size-only texture of a sprite in the last built atlas, matched by file name,
+//for InitSimAssets (the simulation only reads width | height)
+Texture2D AtlasSpriteSize(const char *fileName);
+
+//draw part of a sprite sheet, source is relative to the sprite's top left
+void DrawSprite(const TextureAtlas &atlas, SpriteId sprite, Rectangle source, Rectangle dest, Color tint);
+//draw a whole sprite at pos scaled by scale
+void DrawSpriteEx(const TextureAtlas &atlas, SpriteId sprite, Vector2 pos, float scale, Color tint);
+//solid rectangle from the atlas' white block, no texture switch unlike DrawRectangleRec
+void DrawAtlasRectangle(const TextureAtlas &atlas, Rectangle dest, Color color);
+
+#endif
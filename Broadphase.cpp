@@ -0,0 +1,124 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Sweep-and-prune broadphase
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#include <algorithm>
+#include "Broadphase.h"
+
+//box of entity index in group
+static inline void GroupBox(const BroadphaseGroup &group, int index, float &left, float &top, float &right, float &bottom) {
+    left = group.x[index] + (group.boxX ? group.boxX[index] : 0.0f);
+    top = group.y[index] + (group.boxY ? group.boxY[index] : 0.0f);
+    right = left + (group.width ? group.width[index] : group.uniformWidth);
+    bottom = top + (group.height ? group.height[index] : group.uniformHeight);
+}
+
+static inline bool EntryBefore(const BroadphaseEntry &a, const BroadphaseEntry &b) {
+    return a.left < b.left;
+}
+
+void ResetSweepAndPrune(SweepAndPrune &sap) {
+    sap.order.clear();
+    sap.pairs.clear();
+    sap.tests = 0;
+}
+
+void UpdateSweepAndPrune(SweepAndPrune &sap, const BroadphaseGroup *groups, int groupCount) {
+    std::vector<BroadphaseEntry> &order = sap.order;
+    const int previous = (int)order.size();
+
+    //every entity back into its slot from the last update. Swap-removes carry the slot
+    //column along with the entity, so the slots of removed entities stay empty
+    for (int slot = 0; slot < previous; slot++) {
+        order[slot].handle = -1;
+    }
+    for (int g = 0; g < groupCount; g++) {
+        const BroadphaseGroup &group = groups[g];
+        for (int i = 0; i < group.count; i++) {
+            int slot = group.slot[i];
+            if (slot >= 0 && slot < previous && order[slot].handle < 0) {
+                order[slot].handle = i * maxBroadphaseGroups + g;
+            } else {
+                group.slot[i] = -1;
+            }
+        }
+    }
+
+    //close the gaps, the survivors keep their relative order
+    int survivors = 0;
+    for (int slot = 0; slot < previous; slot++) {
+        if (order[slot].handle >= 0) {
+            order[survivors++] = order[slot];
+        }
+    }
+    order.resize(survivors);
+    //new entities after them
+    for (int g = 0; g < groupCount; g++) {
+        const BroadphaseGroup &group = groups[g];
+        for (int i = 0; i < group.count; i++) {
+            if (group.slot[i] < 0) {
+                order.push_back((BroadphaseEntry){0.0f, i * maxBroadphaseGroups + g});
+            }
+        }
+    }
+    const int count = (int)order.size();
+
+    //current left edges
+    for (int slot = 0; slot < count; slot++) {
+        const BroadphaseGroup &group = groups[order[slot].handle % maxBroadphaseGroups];
+        int index = order[slot].handle / maxBroadphaseGroups;
+        order[slot].left = group.x[index] + (group.boxX ? group.boxX[index] : 0.0f);
+    }
+    //survivors barely moved relative to each other: insertion sort, few moves
+    for (int slot = 1; slot < survivors; slot++) {
+        BroadphaseEntry entry = order[slot];
+        int to = slot;
+        while (to > 0 && order[to - 1].left > entry.left) {
+            order[to] = order[to - 1];
+            to--;
+        }
+        order[to] = entry;
+    }
+    //new entities can land anywhere, sort them on their own and merge
+    if (survivors < count) {
+        std::stable_sort(order.begin() + survivors, order.end(), EntryBefore);
+        std::inplace_merge(order.begin(), order.begin() + survivors, order.end(), EntryBefore);
+    }
+
+    //remaining edges in sorted order, and every entity's new slot
+    sap.right.resize(count);
+    sap.top.resize(count);
+    sap.bottom.resize(count);
+    for (int slot = 0; slot < count; slot++) {
+        const BroadphaseGroup &group = groups[order[slot].handle % maxBroadphaseGroups];
+        int index = order[slot].handle / maxBroadphaseGroups;
+        GroupBox(group, index, order[slot].left, sap.top[slot], sap.right[slot], sap.bottom[slot]);
+        group.slot[index] = slot;
+    }
+
+    //sweep: each box only meets the boxes that start before it ends
+    sap.pairs.clear();
+    long long tests = 0;
+    for (int a = 0; a < count; a++) {
+        const float right = sap.right[a];
+        const float top = sap.top[a];
+        const float bottom = sap.bottom[a];
+        for (int b = a + 1; b < count && order[b].left < right; b++) {
+            tests++;
+            //same strict overlap as CheckCollisionRecs
+            if (top < sap.bottom[b] && bottom > sap.top[b]) {
+                BroadphasePair pair;
+                pair.groupA = order[a].handle % maxBroadphaseGroups;
+                pair.indexA = order[a].handle / maxBroadphaseGroups;
+                pair.groupB = order[b].handle % maxBroadphaseGroups;
+                pair.indexB = order[b].handle / maxBroadphaseGroups;
+                sap.pairs.push_back(pair);
+            }
+        }
+    }
+    sap.tests = tests;
+}
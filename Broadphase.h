@@ -0,0 +1,72 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Sweep-and-prune broadphase
+*
+*   Finds every overlapping pair of entity boxes across several entity stores. Entities
+*   are kept sorted by left edge from one update to the next; everything scrolls left at
+*   similar speeds, so the order barely changes and an insertion sort restores it in close
+*   to linear time. The sweep then only compares boxes whose x ranges overlap.
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#ifndef MOCHI_BROADPHASE_H
+#define MOCHI_BROADPHASE_H
+
+#include <vector>
+
+//most entity stores one broadphase handles
+const int maxBroadphaseGroups = 2;
+
+//one entity store's boxes, box i is (x[i] + boxX, y[i] + boxY, width, height).
+//Per-entity arrays may be null, the uniform value is used instead
+struct BroadphaseGroup {
+    int count;
+    const float *x;
+    const float *y;
+    const float *boxX;
+    const float *boxY;
+    const float *width;
+    const float *height;
+    float uniformWidth;
+    float uniformHeight;
+    //per-entity column the broadphase keeps its position in, new entities start at -1
+    int *slot;
+};
+
+//one overlapping pair, a comes before b in the sorted order
+struct BroadphasePair {
+    int groupA;
+    int indexA;
+    int groupB;
+    int indexB;
+};
+
+//one entity in the sorted order, handle is index * maxBroadphaseGroups + group
+struct BroadphaseEntry {
+    float left;
+    int handle;
+};
+
+struct SweepAndPrune {
+    //entities sorted by left edge
+    std::vector<BroadphaseEntry> order;
+    //other box edges in sorted order, refreshed every update
+    std::vector<float> right;
+    std::vector<float> top;
+    std::vector<float> bottom;
+    //overlapping pairs found by the last update
+    std::vector<BroadphasePair> pairs;
+    //box tests the last sweep did, to spot scaling cliffs
+    long long tests;
+};
+
+//forget every entity, e.g. when the stores are cleared
+void ResetSweepAndPrune(SweepAndPrune &sap);
+//bring the order up to date with the groups (entities may have moved, spawned or
+//been swap-removed since the last update) and collect the overlapping pairs.
+//Survivors are insertion sorted, new entities sorted on their own and merged in
+void UpdateSweepAndPrune(SweepAndPrune &sap, const BroadphaseGroup *groups, int groupCount);
+
+#endif
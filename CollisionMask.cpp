@@ -0,0 +1,102 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Collision masks
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#include <algorithm>
+#include "AssetPack.h"
+#include "CollisionMask.h"
+#include "Trace.h"
+
+void BuildSpriteMask(SpriteMask &mask, Image sheet, int frameCount) {
+    mask = SpriteMask{};
+    if (sheet.data == nullptr || sheet.width < frameCount || frameCount <= 0) {
+        return;
+    }
+    mask.frameCount = frameCount;
+    mask.frameWidth = sheet.width / frameCount;
+    mask.frameHeight = sheet.height;
+    mask.wordsPerRow = (mask.frameWidth + 63) / 64;
+    mask.rows.assign((size_t)frameCount * mask.frameHeight * mask.wordsPerRow, 0);
+
+    //any pixel format, read back as RGBA
+    Color *pixels = LoadImageColors(sheet);
+    for (int frame = 0; frame < frameCount; frame++) {
+        for (int y = 0; y < mask.frameHeight; y++) {
+            const Color *sheetRow = pixels + (size_t)y * sheet.width + frame * mask.frameWidth;
+            uint64_t *row = mask.rows.data() + ((size_t)frame * mask.frameHeight + y) * mask.wordsPerRow;
+            for (int x = 0; x < mask.frameWidth; x++) {
+                if (sheetRow[x].a >= maskAlphaThreshold) {
+                    row[x / 64] |= 1ULL << (x % 64);
+                }
+            }
+        }
+    }
+    UnloadImageColors(pixels);
+}
+
+void LoadSpriteMask(SpriteMask &mask, const char *fileName, int frameCount) {
+    TraceClock::time_point start = TraceClock::now();
+    //the pack holds it decoded already, a view that is not unloaded
+    Image sheet;
+    if (FindPackedImage(fileName, sheet)) {
+        BuildSpriteMask(mask, sheet, frameCount);
+    } else {
+        sheet = LoadImage(fileName);
+        BuildSpriteMask(mask, sheet, frameCount);
+        UnloadImage(sheet);
+    }
+    TraceComplete(fileName, "mask", start, TraceClock::now());
+}
+
+const uint64_t *SpriteMaskRow(const SpriteMask &mask, int frame, int row) {
+    return mask.rows.data() + ((size_t)frame * mask.frameHeight + row) * mask.wordsPerRow;
+}
+
+//64 mask bits starting at bit offset of row, bits outside the row read as 0
+static uint64_t RowBits(const uint64_t *row, int words, int offset) {
+    //floor division, offset goes negative when the other sprite starts further left
+    int word = offset >= 0 ? offset / 64 : -((63 - offset) / 64);
+    int bit = offset - word * 64;
+    uint64_t low = (word >= 0 && word < words) ? row[word] : 0;
+    if (bit == 0) {
+        return low;
+    }
+    uint64_t high = (word + 1 >= 0 && word + 1 < words) ? row[word + 1] : 0;
+    return (low >> bit) | (high << (64 - bit));
+}
+
+bool SpriteMasksOverlap(const SpriteMask &a, int frameA, int ax, int ay, const SpriteMask &b, int frameB, int bx, int by) {
+    if (a.frameCount == 0 || b.frameCount == 0) {
+        return false;
+    }
+    frameA = ((frameA % a.frameCount) + a.frameCount) % a.frameCount;
+    frameB = ((frameB % b.frameCount) + b.frameCount) % b.frameCount;
+
+    //overlap of the two frames on screen
+    int left = std::max(ax, bx);
+    int right = std::min(ax + a.frameWidth, bx + b.frameWidth);
+    int top = std::max(ay, by);
+    int bottom = std::min(ay + a.frameHeight, by + b.frameHeight);
+    if (left >= right || top >= bottom) {
+        return false;
+    }
+
+    //only a's words covering the overlap, b's row is shifted onto a's bit positions
+    int firstWord = (left - ax) / 64;
+    int lastWord = (right - 1 - ax) / 64;
+    int shift = ax - bx;
+    for (int y = top; y < bottom; y++) {
+        const uint64_t *rowA = SpriteMaskRow(a, frameA, y - ay);
+        const uint64_t *rowB = SpriteMaskRow(b, frameB, y - by);
+        for (int word = firstWord; word <= lastWord; word++) {
+            if (rowA[word] & RowBits(rowB, b.wordsPerRow, word * 64 + shift)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,46 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Collision masks
+*
+*   1-bit alpha masks of every frame in a sprite sheet, built once at load time. Rows are
+*   packed into 64-bit words so a pixel-exact overlap test is a few shifts and ANDs per row,
+*   used as the narrow phase after a bounding box hit.
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#ifndef MOCHI_COLLISION_MASK_H
+#define MOCHI_COLLISION_MASK_H
+
+#include <cstdint>
+#include <vector>
+#include "raylib.h"
+
+//alpha at or above this counts as solid
+const int maskAlphaThreshold = 128;
+
+//frames sit side by side in the sheet, frameWidth apart. Bit j of word w in a row is
+//pixel w * 64 + j of that frame row, bits past frameWidth stay 0
+struct SpriteMask {
+    int frameCount;
+    int frameWidth;
+    int frameHeight;
+    int wordsPerRow;
+    //frame, then row, then word
+    std::vector<uint64_t> rows;
+};
+
+//mask of every frame of sheet, frameWidth = sheet width / frameCount
+void BuildSpriteMask(SpriteMask &mask, Image sheet, int frameCount);
+//decode fileName on the CPU and build its mask, empty when the file is missing
+void LoadSpriteMask(SpriteMask &mask, const char *fileName, int frameCount);
+
+//first word of one frame row
+const uint64_t *SpriteMaskRow(const SpriteMask &mask, int frame, int row);
+
+//true when a solid pixel of frameA drawn at (ax, ay) covers a solid pixel of frameB
+//drawn at (bx, by), frames outside the sheet wrap around
+bool SpriteMasksOverlap(const SpriteMask &a, int frameA, int ax, int ay, const SpriteMask &b, int frameB, int bx, int by);
+
+#endif
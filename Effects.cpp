@@ -0,0 +1,120 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Effects
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include "Effects.h"
+#include "SimdKernels.h"
+
+const ParticleEmitter particleEmitters[PARTICLE_KIND_COUNT] = {
+    //dust, a low puff up and to the sides
+    {8, 40.0f, 120.0f, 200.0f, 340.0f, 0.25f, 0.5f, 3.0f, (Color){200, 190, 170, 255}},
+    //sparks, all around
+    {12, 150.0f, 400.0f, 0.0f, 360.0f, 0.2f, 0.45f, 2.0f, (Color){255, 200, 60, 255}}
+};
+
+void InitImpactEffects(ImpactEffects &impacts, int capacity, const AnimationClip &clip) {
+    impacts.count = 0;
+    impacts.capacity = capacity;
+    impacts.x.assign(capacity, 0.0f);
+    impacts.y.assign(capacity, 0.0f);
+    impacts.clip = clip;
+    InitAnimator(impacts.animation, capacity);
+}
+
+bool SpawnImpactEffect(ImpactEffects &impacts, Vector2 pos) {
+    if (impacts.count >= impacts.capacity) {
+        return false;
+    }
+    int i = impacts.count++;
+    AddAnimation(impacts.animation);
+    PlayAnimation(impacts.animation, i, impacts.clip);
+    impacts.x[i] = pos.x;
+    impacts.y[i] = pos.y;
+    return true;
+}
+
+void UpdateImpactEffects(ImpactEffects &impacts, float dT) {
+    AdvanceAnimations(impacts.animation, dT);
+
+    //drop the ones whose last frame played, back to front so swaps stay valid
+    for (int i = impacts.count - 1; i >= 0; i--) {
+        if (impacts.animation.finished[i]) {
+            int last = --impacts.count;
+            impacts.x[i] = impacts.x[last];
+            impacts.y[i] = impacts.y[last];
+            RemoveAnimation(impacts.animation, i);
+        }
+    }
+}
+
+void ClearImpactEffects(ImpactEffects &impacts) {
+    impacts.count = 0;
+    impacts.animation.count = 0;
+}
+
+void InitParticleStore(ParticleStore &particles, int capacity) {
+    capacity = std::max(0, std::min(capacity, maxParticleCapacity));
+    particles.count = 0;
+    particles.capacity = capacity;
+    particles.x.assign(capacity, 0.0f);
+    particles.y.assign(capacity, 0.0f);
+    particles.prevX.assign(capacity, 0.0f);
+    particles.prevY.assign(capacity, 0.0f);
+    particles.vx.assign(capacity, 0.0f);
+    particles.vy.assign(capacity, 0.0f);
+    particles.life.assign(capacity, 0.0f);
+    particles.lifetime.assign(capacity, 0.0f);
+    particles.kind.assign(capacity, 0);
+    particles.expired.assign(capacity, 0);
+}
+
+int EmitParticles(ParticleStore &particles, ParticleKind kind, Vector2 pos, Rng &rng) {
+    const ParticleEmitter &emitter = particleEmitters[kind];
+    int emitted = std::min(emitter.count, particles.capacity - particles.count);
+    for (int n = 0; n < emitted; n++) {
+        int i = particles.count++;
+        float speed = RngFloat(rng, emitter.minSpeed, emitter.maxSpeed);
+        float angle = RngFloat(rng, emitter.minAngle, emitter.maxAngle) * DEG2RAD;
+        particles.x[i] = pos.x;
+        particles.y[i] = pos.y;
+        particles.prevX[i] = pos.x;
+        particles.prevY[i] = pos.y;
+        particles.vx[i] = cosf(angle) * speed;
+        particles.vy[i] = sinf(angle) * speed;
+        particles.life[i] = RngFloat(rng, emitter.minLife, emitter.maxLife);
+        particles.lifetime[i] = particles.life[i];
+        particles.kind[i] = (unsigned char)kind;
+    }
+    return emitted;
+}
+
+void UpdateParticles(ParticleStore &particles, float dT) {
+    int expired = StepParticles(particles.x.data(), particles.y.data(), particles.vx.data(), particles.vy.data(),
+                                particles.life.data(), particles.count, particleGravity, dT, particles.expired.data());
+
+    //back to front so swaps stay valid
+    for (int n = expired - 1; n >= 0; n--) {
+        int i = particles.expired[n];
+        int last = --particles.count;
+        particles.x[i] = particles.x[last];
+        particles.y[i] = particles.y[last];
+        particles.prevX[i] = particles.prevX[last];
+        particles.prevY[i] = particles.prevY[last];
+        particles.vx[i] = particles.vx[last];
+        particles.vy[i] = particles.vy[last];
+        particles.life[i] = particles.life[last];
+        particles.lifetime[i] = particles.lifetime[last];
+        particles.kind[i] = particles.kind[last];
+    }
+}
+
+void SaveParticlePositions(ParticleStore &particles) {
+    std::copy(particles.x.begin(), particles.x.begin() + particles.count, particles.prevX.begin());
+    std::copy(particles.y.begin(), particles.y.begin() + particles.count, particles.prevY.begin());
+}
@@ -0,0 +1,100 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Effects
+*
+*   Impact explosions and particles (dust when Mochi lands, sparks on drone hits). Both
+*   are fixed-capacity pools allocated once, packed like the entity stores, and updated in
+*   bulk: the explosions through the animator, the particles through a SIMD kernel. When a
+*   pool is full new effects are dropped, so nothing allocates during play.
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#ifndef MOCHI_EFFECTS_H
+#define MOCHI_EFFECTS_H
+
+#include <vector>
+#include "raylib.h"
+#include "Animator.h"
+#include "Random.h"
+
+//impact explosions playing at once
+const int maxImpactEffects = 16;
+//particle pool size (--particles <n>), capped for throughput benchmarks
+const int defaultParticleCapacity = 1024;
+const int maxParticleCapacity = 100000;
+//px/s/s, particles fall slower than Mochi so sparks hang in the air a little
+const float particleGravity = 900.0f;
+
+//Impact explosions, one-shot animation i plays at (x[i], y[i]), removed once finished
+struct ImpactEffects {
+    int count;
+    int capacity;
+    std::vector<float> x;
+    std::vector<float> y;
+    AnimationClip clip;
+    Animator animation;
+};
+
+enum ParticleKind {
+    PARTICLE_DUST,
+    PARTICLE_SPARK,
+    PARTICLE_KIND_COUNT
+};
+
+//how one kind of burst looks, speeds in px/s, angles in degrees (0 right, 90 down)
+struct ParticleEmitter {
+    int count;
+    float minSpeed;
+    float maxSpeed;
+    float minAngle;
+    float maxAngle;
+    //seconds
+    float minLife;
+    float maxLife;
+    float size;
+    Color color;
+};
+
+//built in emitters, indexed by ParticleKind
+extern const ParticleEmitter particleEmitters[PARTICLE_KIND_COUNT];
+
+//Particles, packed like EnemyStore, dead ones are swap-removed after each update
+struct ParticleStore {
+    int count;
+    int capacity;
+    std::vector<float> x;
+    std::vector<float> y;
+    //position before the current tick, for drawing between ticks
+    std::vector<float> prevX;
+    std::vector<float> prevY;
+    std::vector<float> vx;
+    std::vector<float> vy;
+    //seconds left | at spawn, drawing fades by their ratio
+    std::vector<float> life;
+    std::vector<float> lifetime;
+    std::vector<unsigned char> kind;
+    //indices of the particles whose life ran out this step, scratch
+    std::vector<int> expired;
+};
+
+//sized once, clip is the explosion's sprite sheet
+void InitImpactEffects(ImpactEffects &impacts, int capacity, const AnimationClip &clip);
+//start an explosion with its top left at pos, false when the pool is full
+bool SpawnImpactEffect(ImpactEffects &impacts, Vector2 pos);
+//advance every explosion, drop the finished ones
+void UpdateImpactEffects(ImpactEffects &impacts, float dT);
+void ClearImpactEffects(ImpactEffects &impacts);
+
+//sized once, at most maxParticleCapacity
+void InitParticleStore(ParticleStore &particles, int capacity);
+//burst of kind at pos with random speeds | angles | lifetimes from rng, returns how many
+//fit (the rest are dropped)
+int EmitParticles(ParticleStore &particles, ParticleKind kind, Vector2 pos, Rng &rng);
+//move | age every particle, drop the expired ones
+void UpdateParticles(ParticleStore &particles, float dT);
+//keep the current positions for interpolation, at the start of a tick
+void SaveParticlePositions(ParticleStore &particles);
+
+#endif
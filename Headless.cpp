@@ -0,0 +1,211 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Headless runner
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include "raylib.h"
+#include "Headless.h"
+#include "Replay.h"
+#include "SimdKernels.h"
+#include "Simulation.h"
+#include "Trace.h"
+
+//decode the image on the CPU and keep only its size, no GPU upload
+Texture2D LoadTextureSize(const char *fileName) {
+    Image image = LoadImage(fileName);
+    Texture2D texture = {0};
+    texture.width = image.width;
+    texture.height = image.height;
+    texture.mipmaps = 1;
+    texture.format = image.format;
+    UnloadImage(image);
+    return texture;
+}
+
+//scripted input: jump when a low drone is about to reach Mochi
+static SimInput AutopilotInput(const GameSim &sim, const SimAssets &assets) {
+    SimInput input = {false};
+    const AnimationData &mochiData = sim.mochiData;
+    const EnemyStore &enemies = sim.enemies;
+
+    for (int i = 0; i < enemies.count; i++) {
+        //air drones fly over Mochi's head while on the ground
+        if (enemies.y[i] + assets.drones[enemies.type[i]].texture.height * 0.5f < mochiData.pos.y) {
+            continue;
+        }
+        float distance = enemies.x[i] - (mochiData.pos.x + mochiData.rec.width);
+        if (distance > 0.0f && distance < enemies.speed[i] * 0.15f) {
+            input.jump = true;
+        }
+    }
+    return input;
+}
+
+//sprite sizes for the window the simulation is laid out for
+static void LoadHeadlessAssets(SimAssets &assets) {
+    //window dimensions
+    const int screenWidth = 700;
+    const int screenHeight = 300;
+
+    SetTraceLogLevel(LOG_WARNING);
+    InitSimAssets(assets, screenWidth, screenHeight, LoadTextureSize);
+}
+
+int RunHeadless(const GameOptions &options) {
+    //same fixed tick as the windowed game
+    const float dt = 1.0f / options.tickRate;
+
+    SimAssets assets;
+    LoadHeadlessAssets(assets);
+
+    //tick phases and spawns as trace events (--trace)
+    if (options.tracePath && !OpenTrace(options.tracePath)) {
+        printf("trace: could not create %s\n", options.tracePath);
+    }
+
+    GameSim sim;
+    if (options.stressCount > 0) {
+        InitStressSim(sim, assets, options.seed, options.stressCount, options.particleCapacity);
+    } else {
+        InitGameSim(sim, assets, options.seed, maxEnemies, maxHealthPickups, options.particleCapacity);
+    }
+
+    //one "tick hash" line per tick, diff two logs to find the first divergence
+    FILE *hashLog = options.hashLogPath ? fopen(options.hashLogPath, "w") : nullptr;
+
+    long long runs = 1;
+    long long jumps = 0;
+    long long hits = 0;
+    double bestTime = 0.0;
+    //stress mode totals, averaged per tick at the end
+    long long liveEntities = 0;
+    long long pairs = 0;
+    long long tests = 0;
+    long long liveParticles = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (long long tick = 0; tick < options.headlessTicks; tick++) {
+        StepGameSim(sim, assets, AutopilotInput(sim, assets), dt);
+        if (hashLog) {
+            fprintf(hashLog, "%lld %016llx\n", tick, (unsigned long long)HashGameSim(sim));
+        }
+
+        if (sim.events & SIM_EVENT_JUMP) jumps++;
+        if (sim.events & SIM_EVENT_IMPACT) hits++;
+        liveEntities += sim.enemies.count + sim.healthPickups.count;
+        pairs += (long long)sim.broadphase.pairs.size();
+        tests += sim.broadphase.tests;
+        liveParticles += sim.particles.count;
+
+        //start a new attempt straight away
+        if (sim.gameOver) {
+            if (sim.gameTime > bestTime) bestTime = sim.gameTime;
+            ResetGameSim(sim, assets);
+            runs++;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    if (hashLog) {
+        fclose(hashLog);
+    }
+    CloseTrace();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    if (sim.gameTime > bestTime) bestTime = sim.gameTime;
+
+    printf("ticks: %lld at %d Hz (%.1f s of game time)\n", options.headlessTicks, options.tickRate, options.headlessTicks * (double)dt);
+    printf("seed: %llu, final state hash: %016llx\n", (unsigned long long)options.seed, (unsigned long long)HashGameSim(sim));
+    printf("runs: %lld, jumps: %lld, hits: %lld, best run: %.1f s\n", runs, jumps, hits, bestTime);
+    printf("elapsed: %.3f s, %.0f ticks/s (%s kernels)\n", seconds, seconds > 0.0 ? options.headlessTicks / seconds : 0.0, SimdLevelName(GetSimdLevel()));
+    if (options.stressCount > 0 && options.headlessTicks > 0) {
+        double perTick = 1.0 / options.headlessTicks;
+        printf("stress: %d per store, per tick %.0f live entities, %.0f box tests, %.1f colliding pairs, %.0f particles (of %d), %.3f ms\n", options.stressCount,
+               liveEntities * perTick, tests * perTick, pairs * perTick, liveParticles * perTick, sim.particles.capacity, seconds * 1e3 * perTick);
+    }
+
+    return 0;
+}
+
+int RunReplayFast(const GameOptions &options) {
+    ReplayReader replay;
+    if (!OpenReplayReader(replay, options.replayPath)) {
+        printf("replay: could not read %s\n", options.replayPath);
+        return 1;
+    }
+    //the recording decides seed and tick rate
+    const float dt = 1.0f / replay.header.tickRate;
+
+    SimAssets assets;
+    LoadHeadlessAssets(assets);
+
+    //tick phases and spawns as trace events (--trace)
+    if (options.tracePath && !OpenTrace(options.tracePath)) {
+        printf("trace: could not create %s\n", options.tracePath);
+    }
+
+    GameSim sim;
+    InitGameSim(sim, assets, replay.header.seed, maxEnemies, maxHealthPickups, options.particleCapacity);
+
+    FILE *hashLog = options.hashLogPath ? fopen(options.hashLogPath, "w") : nullptr;
+
+    //try again prompt, same rules as the GAMEOVER state
+    bool tryAgainYes = true;
+    long long tick = 0;
+    long long runs = 1;
+
+    auto start = std::chrono::steady_clock::now();
+    while (!ReplayFinished(replay, tick)) {
+        if (sim.gameOver) {
+            //play the prompt keys pressed while this game over was showing
+            unsigned int inputs = 0;
+            while (TakeReplayInput(replay, tick, replayMenuInputs, inputs)) {
+                if (inputs & REPLAY_MENU_W) {
+                    tryAgainYes = true;
+                } else if (inputs & REPLAY_MENU_S) {
+                    tryAgainYes = false;
+                } else if ((inputs & REPLAY_MENU_ENTER) && tryAgainYes) {
+                    ResetGameSim(sim, assets);
+                    runs++;
+                }
+            }
+            if (ReplayFinished(replay, tick)) {
+                break;
+            }
+            //back through the intro, the countdown resets the run
+            if (sim.gameOver) {
+                ResetGameSim(sim, assets);
+                runs++;
+            }
+        }
+
+        unsigned int inputs = 0;
+        SimInput input = {TakeReplayInput(replay, tick, REPLAY_JUMP, inputs)};
+        StepGameSim(sim, assets, input, dt);
+        if (hashLog) {
+            fprintf(hashLog, "%lld %016llx\n", tick, (unsigned long long)HashGameSim(sim));
+        }
+        tick++;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    if (hashLog) {
+        fclose(hashLog);
+    }
+    CloseTrace();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    uint64_t hash = HashGameSim(sim);
+
+    printf("replay: %s, seed %llu, %d Hz\n", options.replayPath, (unsigned long long)replay.header.seed, replay.header.tickRate);
+    printf("ticks: %lld (%.1f s of game time), runs: %lld\n", tick, tick * (double)dt, runs);
+    printf("elapsed: %.3f s, %.0fx real time\n", seconds, seconds > 0.0 ? tick * (double)dt / seconds : 0.0);
+    printf("final state hash: %016llx (%s)\n", (unsigned long long)hash, hash == replay.endHash ? "matches recording" : "DIFFERS from recording");
+
+    return hash == replay.endHash ? 0 : 2;
+}
@@ -0,0 +1,27 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Headless runner
+*
+*   Runs GAMEPLAY ticks with no window, audio device or GPU for soak tests and profiling.
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#ifndef MOCHI_HEADLESS_H
+#define MOCHI_HEADLESS_H
+
+#include "raylib.h"
+#include "Options.h"
+
+//texture with only width | height filled from the decoded image, no GPU needed
+Texture2D LoadTextureSize(const char *fileName);
+
+//simulate with scripted input, restarting on game over, and print throughput
+int RunHeadless(const GameOptions &options);
+
+//play options.replayPath back with no window as fast as possible and check
+//the final state hash against the recording, returns non-zero on mismatch
+int RunReplayFast(const GameOptions &options);
+
+#endif
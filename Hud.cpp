@@ -0,0 +1,92 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Numeric HUD
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#include "Hud.h"
+
+static const int hudFontSizes[HUD_SIZE_COUNT] = {20, 60};
+//gap between glyphs in the texture so filtering never picks up a neighbour
+static const int hudGlyphPadding = 1;
+
+bool LoadHudDigits(HudDigits &hud) {
+    //one row per size, laid out before rendering to size the image
+    int width = 0;
+    int height = 0;
+    for (int size = 0; size < HUD_SIZE_COUNT; size++) {
+        HudDigitFont &font = hud.fonts[size];
+        font.fontSize = hudFontSizes[size];
+        //default font spacing is fontSize / 10, see DrawText
+        int spacing = font.fontSize / 10;
+        int x = hudGlyphPadding;
+        for (int digit = 0; digit < 10; digit++) {
+            const char text[2] = {(char)('0' + digit), '\0'};
+            int glyphWidth = MeasureText(text, font.fontSize);
+            font.glyphs[digit] = (Rectangle){(float)x, (float)(height + hudGlyphPadding), (float)glyphWidth, (float)font.fontSize};
+            font.advance[digit] = glyphWidth + spacing;
+            x += glyphWidth + hudGlyphPadding;
+        }
+        if (x > width) width = x;
+        height += font.fontSize + hudGlyphPadding;
+    }
+    height += hudGlyphPadding;
+
+    Image image = GenImageColor(width, height, BLANK);
+    for (int size = 0; size < HUD_SIZE_COUNT; size++) {
+        HudDigitFont &font = hud.fonts[size];
+        for (int digit = 0; digit < 10; digit++) {
+            const char text[2] = {(char)('0' + digit), '\0'};
+            Image glyph = ImageText(text, font.fontSize, WHITE);
+            Rectangle source = {0, 0, (float)glyph.width, (float)glyph.height};
+            ImageDraw(&image, glyph, source, font.glyphs[digit], WHITE);
+            UnloadImage(glyph);
+        }
+    }
+    hud.texture = LoadTextureFromImage(image);
+    UnloadImage(image);
+    return hud.texture.id != 0;
+}
+
+void UnloadHudDigits(HudDigits &hud) {
+    UnloadTexture(hud.texture);
+    hud.texture = (Texture2D){0};
+}
+
+//place value of the leading digit of value padded to minDigits
+static long long LeadingDivisor(int value, int minDigits) {
+    long long divisor = 1;
+    int digits = 1;
+    while (digits < minDigits || divisor * 10 <= value) {
+        divisor *= 10;
+        digits++;
+    }
+    return divisor;
+}
+
+int MeasureHudNumber(const HudDigits &hud, HudFontSize size, int value, int minDigits) {
+    const HudDigitFont &font = hud.fonts[size];
+    if (value < 0) value = 0;
+
+    int width = 0;
+    for (long long divisor = LeadingDivisor(value, minDigits); divisor > 0; divisor /= 10) {
+        width += font.advance[(value / divisor) % 10];
+    }
+    //no spacing after the last glyph, same as MeasureText
+    return width - font.fontSize / 10;
+}
+
+void DrawHudNumber(const HudDigits &hud, HudFontSize size, int value, int minDigits, int x, int y, Color tint) {
+    const HudDigitFont &font = hud.fonts[size];
+    if (value < 0) value = 0;
+
+    float penX = (float)x;
+    for (long long divisor = LeadingDivisor(value, minDigits); divisor > 0; divisor /= 10) {
+        int digit = (int)((value / divisor) % 10);
+        const Rectangle &glyph = font.glyphs[digit];
+        DrawTextureRec(hud.texture, glyph, (Vector2){penX, (float)y}, tint);
+        penX += font.advance[digit];
+    }
+}
@@ -0,0 +1,47 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Numeric HUD
+*
+*   Digits 0-9 of the default font pre-rendered at the HUD sizes into one small texture,
+*   so the score and countdown draw straight from integers: no TextFormat, no MeasureText
+*   and no string building per frame.
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#ifndef MOCHI_HUD_H
+#define MOCHI_HUD_H
+
+#include "raylib.h"
+
+//font sizes that get glyphs, matching the DrawText sizes they replace
+enum HudFontSize {
+    HUD_SCORE,      //20, gameplay score
+    HUD_COUNTDOWN,  //60, countdown digits
+    HUD_SIZE_COUNT
+};
+
+//one digit set, glyph rects point into HudDigits::texture
+struct HudDigitFont {
+    int fontSize;
+    Rectangle glyphs[10];
+    //glyph width plus the default font spacing, same advance DrawText uses
+    int advance[10];
+};
+
+struct HudDigits {
+    Texture2D texture;
+    HudDigitFont fonts[HUD_SIZE_COUNT];
+};
+
+//render the glyphs (needs the window for the default font), white so draws can tint them
+bool LoadHudDigits(HudDigits &hud);
+void UnloadHudDigits(HudDigits &hud);
+
+//width of value printed with at least minDigits digits (zero padded, like %0Nd)
+int MeasureHudNumber(const HudDigits &hud, HudFontSize size, int value, int minDigits);
+//draw value zero padded to minDigits with its top left at x, y
+void DrawHudNumber(const HudDigits &hud, HudFontSize size, int value, int minDigits, int x, int y, Color tint);
+
+#endif
@@ -0,0 +1,85 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Memory-mapped files
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+bool OpenMappedFile(MappedFile &mapped, const char *fileName) {
+    mapped = MappedFile{};
+    HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void *view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    mapped.data = static_cast<const unsigned char *>(view);
+    mapped.size = (size_t)size.QuadPart;
+    mapped.file = (long long)(intptr_t)file;
+    mapped.mapping = mapping;
+    return true;
+}
+
+void CloseMappedFile(MappedFile &mapped) {
+    if (mapped.data) {
+        UnmapViewOfFile(mapped.data);
+        CloseHandle((HANDLE)mapped.mapping);
+        CloseHandle((HANDLE)(intptr_t)mapped.file);
+    }
+    mapped = MappedFile{};
+}
+
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+bool OpenMappedFile(MappedFile &mapped, const char *fileName) {
+    mapped = MappedFile{};
+    int file = open(fileName, O_RDONLY);
+    if (file < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size == 0) {
+        close(file);
+        return false;
+    }
+    void *view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    //the mapping keeps the file alive
+    close(file);
+    if (view == MAP_FAILED) {
+        return false;
+    }
+    mapped.data = static_cast<const unsigned char *>(view);
+    mapped.size = (size_t)info.st_size;
+    mapped.file = -1;
+    return true;
+}
+
+void CloseMappedFile(MappedFile &mapped) {
+    if (mapped.data) {
+        munmap(const_cast<unsigned char *>(mapped.data), mapped.size);
+    }
+    mapped = MappedFile{};
+}
+
+#endif
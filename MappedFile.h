@@ -0,0 +1,29 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Memory-mapped files
+*
+*   Read-only mapping of a whole file. Kept apart from everything that includes raylib.h,
+*   windows.h clashes with raylib's names.
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#ifndef MOCHI_MAPPED_FILE_H
+#define MOCHI_MAPPED_FILE_H
+
+#include <cstddef>
+
+struct MappedFile {
+    const unsigned char *data;
+    size_t size;
+    //platform handles (file descriptor | file and mapping handles)
+    long long file;
+    void *mapping;
+};
+
+//map fileName read-only, false if it is missing, empty or cannot be mapped
+bool OpenMappedFile(MappedFile &mapped, const char *fileName);
+void CloseMappedFile(MappedFile &mapped);
+
+#endif
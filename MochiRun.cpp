@@ -25,16 +25,34 @@
 *
 ********************************************************************************************/
 
+#include <atomic>
+#include <cstdio>
 #include <cstdlib>
 #include <ctime>
+#include <thread>
 #include "raylib.h"
+#include "AssetLoader.h"
+#include "Atlas.h"
+#include "Headless.h"
+#include "Hud.h"
+#include "MusicPlayer.h"
+#include "Options.h"
+#include "Profiler.h"
+#include "RenderSnapshot.h"
+#include "Replay.h"
+#include "SimdKernels.h"
+#include "SoundPool.h"
+#include "Trace.h"
+#include "UiLayer.h"
+#include "Simulation.h"
 
 //game states
 enum GameState {
     INTRO,
     COUNTDOWN,
     GAMEPLAY,
-    GAMEOVER
+    GAMEOVER,
+    GAME_STATE_COUNT
 };
 
 //try again state, yes or no
@@ -43,866 +61,802 @@ enum TryAgainState {
     NO
 };
 
-//Mochi main animation data
-struct AnimationData {
-    Rectangle rec;
-    Vector2 pos;
-    int frame;
-    float updateTime;
-    float runningTime;
-};
+//window dimensions
+const int screenWidth = 700;
+const int screenHeight = 300;
+
+//intro prompt animation
+const float promptMinScale = 1.0f;
+const float promptMaxScale = 1.15f;
+const float promptScaleSpeed = 0.3f;
+//the start prompt pulses between a few integer font sizes
+const int promptMinSize = 18;
+const int promptSizeCount = 8;
+
+//countdown numbers and "Run!" text
+const int countdownStart = 3;
+const int fontSize = 60;
+
+//everything the game states share, set up in main()
+struct Game {
+    GameState state;
+    //state the current one asked for, switched to after its update
+    GameState nextState;
+    const GameOptions *options;
+    //GetTime() at the start of the frame
+    double currentTime;
+    //time to first frame | time to interactive count from here
+    TraceClock::time_point startupTime;
+
+    //sprite sheets and sounds decode on worker threads while the intro runs
+    AssetLoader loader;
+    //every sprite sheet packed into one texture, draws go through it (built once the
+    //loader has decoded them all)
+    TextureAtlas atlas;
+    //sound effects, indexed by SoundId, from the loader as well
+    Sound sounds[SOUND_COUNT];
+    //voices the effects play on, set up with the sounds
+    SoundPool soundPool;
+    //menu song and soundtrack, refilled on their own thread
+    MusicPlayer music;
+    //score and countdown digits
+    HudDigits hud;
+    //outlined title, rendered once | game over text, rebuilt when score or selection change
+    UiLayer titleLayer;
+    UiLayer gameOverLayer;
+    //atlas, sounds and gameplay state are all there, the intro can be left
+    bool assetsReady;
+
+    //drone types and sprite sizes, shared with the simulation, and the gameplay state
+    //(Mochi, health, drones, pickups, timers), both set up once the atlas exists
+    SimAssets assets;
+    GameSim sim;
+    //fixed rate simulation clock, independent of the render rate
+    SimClock simClock;
+    //ticks simulated so far, replay records are stamped with it
+    long long simTick;
+    //per-tick state hash for comparing builds (--hash-log)
+    FILE *hashLog;
+
+    //replay playback replaces the keyboard, recording captures it. replay | replaying
+    //belong to the simulation thread during GAMEPLAY, the main thread otherwise
+    ReplayReader replay;
+    bool replaying;
+    ReplayWriter recorder;
+
+    //during gameplay the simulation thread owns sim, the clock, the replay | recorder
+    //and the hash log; drawing reads the snapshots it publishes
+    std::thread simThread;
+    std::atomic<bool> simRunning;
+    //jump pressed since the last tick | SimEvent bits not yet played
+    std::atomic<bool> jumpRequested;
+    std::atomic<unsigned int> simEvents;
+    SnapshotBuffer snapshots;
+    //snapshot drawn this frame
+    const RenderSnapshot *snapshot;
 
-//Enemy drone properties
-struct Enemy {
-    Texture2D texture;
-    Vector2 position;
-    float speed;
-    bool active;
-    int frameCount;
-    float frameTime;
-    int currentFrame;
-    float frameTimer;
-    
+    //intro
+    double introTimer;
+    float textScale;
+    bool scalingUp;
+    //countdown
+    double countdownTimer;
+    int countdownValue;
+    //try again prompt
+    TryAgainState tryAgainState;
+    bool tryAgainSelected;
+    //parallax
+    float bgX;
+    float fgX;
+
+    //static text, laid out once instead of measured every frame
+    int madeByX;
+    int runTextX;
+    int promptWidths[promptSizeCount];
 };
 
-//Enemy drone main animation data
-struct Drone {
-    Texture2D texture;
-    int frameCount;
-    float frameTime;
-};
+//draw player health at the top left of the screen
+void DrawPlayerHealth(const TextureAtlas &atlas, HealthSystem healthSystem, bool isInGracePeriod) {
+    int spacing = 10;
+    int heartWidth = healthSystem.heartTexture.width;
 
-//Health pick up properties
-struct HealthPickup {
-    Texture2D texture;
-    Vector2 position;
-    float speed;
-};
+    for (int i = 0; i < healthSystem.currentHealth; i++) {
+        Vector2 heartPosition = {static_cast<float>(10 + i * (heartWidth + spacing)), 10.0f};
+        //alternate upon collision
+        Color textColor = isInGracePeriod ? RED : WHITE;
+        DrawSpriteEx(atlas, SPRITE_MOCHI_HEALTH, heartPosition, 1.0f, textColor);
+    }
+}
 
-//Health system properties
-struct HealthSystem {
-    Texture2D heartTexture;
-    int maxHealth;
-    int currentHealth;
-};
+//stop a 1x replay once it reaches the recorded end, keyboard takes over after
+bool CheckReplayFinished(const ReplayReader &replay, bool &replaying, long long simTick, const GameSim &sim) {
+    if (!ReplayFinished(replay, simTick)) {
+        return false;
+    }
+    replaying = false;
+    TraceLog(LOG_INFO, "REPLAY: finished at tick %lld, state hash %s", simTick, HashGameSim(sim) == replay.endHash ? "matches" : "differs");
+    return true;
+}
 
-//Collision animation data
-struct ImpactAnimation {
-    Texture2D texture;
-    int frameCount;   
-    float frameTime;  
-    int currentFrame; 
-    float frameTimer; 
-    Vector2 position; 
-    bool active;      
-};
+//startup milestone, logged and marked in the trace
+void ReportStartup(const char *milestone, TraceClock::time_point startupTime) {
+    double ms = std::chrono::duration<double, std::milli>(TraceClock::now() - startupTime).count();
+    TraceLog(LOG_INFO, "STARTUP: %s after %.1f ms", milestone, ms);
+    TraceInstant(milestone, "startup");
+}
+
+//switch to next once the current state's update is done
+void SetGameState(Game &game, GameState next) {
+    game.nextState = next;
+}
+
+//upload the assets once the workers decoded them all, then build the gameplay state
+void FinishGameAssets(Game &game) {
+    if (game.assetsReady || !FinishAssetLoader(game.loader, game.atlas, game.sounds)) {
+        return;
+    }
+    InitSoundPool(game.soundPool, game.sounds);
+    InitSimAssets(game.assets, screenWidth, screenHeight, AtlasSpriteSize);
+    if (game.options->stressCount > 0) {
+        //thousands of drones | pickups, entities keep their pre-tick position so
+        //drawing between ticks needs no copy of the whole state
+        InitStressSim(game.sim, game.assets, game.options->seed, game.options->stressCount, game.options->particleCapacity);
+    } else {
+        InitGameSim(game.sim, game.assets, game.options->seed, maxEnemies, maxHealthPickups, game.options->particleCapacity);
+    }
+    //player health hearts
+    game.sim.playerHealth.heartTexture = AtlasSpriteSize("textures/mochi_health.png");
 
-//update animation state of running time
-AnimationData updateAnimData(AnimationData data, float deltaTime, int maxFrame) {
-    data.runningTime += deltaTime;
-    if (data.runningTime >= data.updateTime) {
-        data.runningTime = 0.0;
-        //update animation frame
-        data.rec.x = data.frame * data.rec.width;
-        data.frame++;
-        //reset frame
-        if (data.frame > maxFrame) {
-            data.frame = 0;
+    game.assetsReady = true;
+    ReportStartup("interactive", game.startupTime);
+}
+
+//intro state, "Made by Franz" for 2 seconds (longer while assets load), then the title
+bool IntroTitleShown(const Game &game) {
+    return game.assetsReady && game.currentTime - game.introTimer >= 2.0;
+}
+
+void EnterIntro(Game &game) {
+    //intro song
+    PlayMusicTrack(game.music, MUSIC_MENU, 0.5f);
+}
+
+void UpdateIntro(Game &game) {
+    if (!IntroTitleShown(game)) {
+        return;
+    }
+    //prompt bool animation
+    if (game.scalingUp) {
+        game.textScale += promptScaleSpeed * GetFrameTime();
+        if (game.textScale >= promptMaxScale) {
+            game.scalingUp = false;
+        }
+    } else {
+        game.textScale -= promptScaleSpeed * GetFrameTime();
+        if (game.textScale <= promptMinScale) {
+            game.scalingUp = true;
+        }
+    }
+
+    //check for key press to transition to the countdown state
+    if (IsKeyDown(KEY_SPACE) || game.replaying) {
+        SetGameState(game, COUNTDOWN);
+    }
+}
+
+void DrawIntro(Game &game) {
+    if (!IntroTitleShown(game)) {
+        DrawText("Made by Franz", game.madeByX, screenHeight / 2 - 40, 40, SKYBLUE);
+        //loading bar, only once the 2 seconds are over
+        if (game.currentTime - game.introTimer >= 2.0) {
+            DrawRectangle(screenWidth / 2 - 100, screenHeight / 2 + 20, (int)(200 * AssetLoaderProgress(game.loader)), 4, SKYBLUE);
         }
+        return;
     }
-    return data;
+    const TextureAtlas &atlas = game.atlas;
+    const Rectangle &background = atlas.sprites[SPRITE_BACKGROUND];
+    const Rectangle &foreground = atlas.sprites[SPRITE_FOREGROUND];
+    const Rectangle &mochiIntroSprite = atlas.sprites[SPRITE_MOCHI_INTRO];
+
+    //increases scale factor of prompt
+    float scaleFactorBackground = 2.0;
+    float scaleFactorForeground = 2.0;
+
+    Vector2 bgPos;
+    bgPos.x = 0;
+    bgPos.y = screenHeight - background.height * scaleFactorBackground;
+    DrawSpriteEx(atlas, SPRITE_BACKGROUND, bgPos, scaleFactorBackground, WHITE);
+
+    //adjust the position foreground texture
+    Vector2 fgPos;
+    fgPos.x = -130; // Adjust the x-coordinate to move it horizontally
+    fgPos.y = screenHeight - foreground.height * scaleFactorForeground; // Keep the same y-coordinate
+    DrawSpriteEx(atlas, SPRITE_FOREGROUND, fgPos, scaleFactorForeground, WHITE);
+
+    //draws the intro foreground
+    Vector2 introPos = {10.0f, static_cast<float>(screenHeight - mochiIntroSprite.height - 10)};
+
+    //draws the Mochi shadow (only in intro)
+    Color shadowColor = (Color){0, 0, 0, 150}; // Adjust the alpha value for transparency
+    Vector2 shadowCenter;
+    shadowCenter.x = introPos.x + mochiIntroSprite.width / 2 - 115;
+    shadowCenter.y = screenHeight - 20;
+    int shadowWidth = mochiIntroSprite.width;
+    int shadowHeight = 7;
+    DrawEllipse((int)shadowCenter.x, (int)shadowCenter.y, shadowWidth, shadowHeight, shadowColor);
+    //draws Mochi intro texture
+    DrawSpriteEx(atlas, SPRITE_MOCHI_INTRO, introPos, 1.0f, RAYWHITE);
+
+    //Title text, prerendered with its outline
+    DrawUiLayer(game.titleLayer, 0, 0, WHITE);
+
+    //draws the "Press [SPACE] to Start" text with the current scale
+    int promptSize = (int)(20 * game.textScale);
+    int promptIndex = promptSize - promptMinSize;
+    if (promptIndex < 0) promptIndex = 0;
+    if (promptIndex > promptSizeCount - 1) promptIndex = promptSizeCount - 1;
+    DrawText("Press [SPACE] to START", (screenWidth - 355) - game.promptWidths[promptIndex] / 2, screenHeight - 25, promptSize, RAYWHITE);
 }
 
-//checks player on ground
-bool isOnGround(AnimationData data ,int windowHeight){
-    return data.pos.y >= windowHeight - data.rec.height;
+void ExitIntro(Game &game) {
+    StopMusicTrack(game.music, MUSIC_MENU);
 }
 
-//draw player health at the top left of the screen
-void DrawPlayerHealth(HealthSystem healthSystem, bool isInGracePeriod) {
-    int spacing = 10;
-    int heartWidth = healthSystem.heartTexture.width;
+//countdown state, one number a second then "Run!" for a second
+void EnterCountdown(Game &game) {
+    game.countdownTimer = game.currentTime;
+    game.countdownValue = countdownStart;
+    PlaySoundEffect(game.soundPool, SOUND_ALARM, game.currentTime);
+}
 
-    for (int i = 0; i < healthSystem.currentHealth; i++) {
-        Vector2 heartPosition = {static_cast<float>(10 + i * (heartWidth + spacing)), 10.0f};
-        //alternate upon collision
-        Color textColor = isInGracePeriod ? RED : WHITE;
-        DrawTexture(healthSystem.heartTexture, heartPosition.x, heartPosition.y, textColor);
+void UpdateCountdown(Game &game) {
+    //calculate countdown time
+    double countdownElapsed = game.currentTime - game.countdownTimer;
+    if (countdownElapsed < 1.0) {
+        return;
     }
+
+    //"Run!" shown long enough
+    if (game.countdownValue < 0) {
+        SetGameState(game, GAMEPLAY);
+        return;
+    }
+    //next number, or "Run!" after the last one
+    game.countdownValue--;
+    game.countdownTimer = game.currentTime;
+    PlaySoundEffect(game.soundPool, game.countdownValue >= 0 ? SOUND_ALARM : SOUND_ANGRY, game.currentTime);
 }
 
-//checks for collision (player | health pickup)
-bool CheckCollisionPlayerHealthPickup(AnimationData player, HealthPickup healthPickup) {
-    return CheckCollisionRecs(
-        //position of both player and health pickup
-        (Rectangle){player.pos.x, player.pos.y, static_cast<float>(player.rec.width), static_cast<float>(player.rec.height)},
-        (Rectangle){healthPickup.position.x, healthPickup.position.y, static_cast<float>(healthPickup.texture.width), static_cast<float>(healthPickup.texture.height)}
-    );
+void DrawCountdown(Game &game) {
+    if (game.countdownValue >= 0) {
+        //draws countdown
+        DrawHudNumber(game.hud, HUD_COUNTDOWN, game.countdownValue, 1, screenWidth / 2 - MeasureHudNumber(game.hud, HUD_COUNTDOWN, game.countdownValue, 1) / 2, screenHeight / 2 - fontSize / 2, MAGENTA);
+    } else {
+        //draws run text after countdown
+        DrawText("Run!", game.runTextX, screenHeight / 2 - fontSize / 2, fontSize, RED);
+    }
 }
 
+//simulation thread: advance Mochi, pickups, drones and collisions at the fixed tick rate
+//and publish a snapshot after each batch of ticks, until stopped or the run is over
+void RunSimulation(Game *game) {
+    GameSim &sim = game->sim;
+    TraceClock::time_point last = TraceClock::now();
+    while (game->simRunning && !sim.gameOver) {
+        //sleep until the next tick is due
+        std::this_thread::sleep_for(std::chrono::duration<double>(game->simClock.tickDt - game->simClock.accumulator));
+        TraceClock::time_point now = TraceClock::now();
+        int ticks = AdvanceSimClock(game->simClock, std::chrono::duration<float>(now - last).count());
+        last = now;
+
+        unsigned int events = 0;
+        for (int tick = 0; tick < ticks && !sim.gameOver; tick++) {
+            SimInput input = {game->jumpRequested.exchange(false)};
+            if (game->replaying) {
+                if (CheckReplayFinished(game->replay, game->replaying, game->simTick, sim)) {
+                    break;
+                }
+                unsigned int inputs = 0;
+                input.jump = TakeReplayInput(game->replay, game->simTick, REPLAY_JUMP, inputs);
+            } else if (input.jump) {
+                WriteReplayInput(game->recorder, game->simTick, REPLAY_JUMP);
+            }
+            StepGameSim(sim, game->assets, input, game->simClock.tickDt);
+            events |= sim.events;
+            if (game->hashLog) {
+                fprintf(game->hashLog, "%lld %016llx\n", game->simTick, (unsigned long long)HashGameSim(sim));
+            }
+            game->simTick++;
+        }
+        //before the snapshot, so the frame that sees the run end also plays its last sounds
+        game->simEvents.fetch_or(events);
 
+        ProfilerBegin(PROFILE_SNAPSHOT);
+        CaptureSnapshot(SnapshotToWrite(game->snapshots), sim, game->simClock, now);
+        PublishSnapshot(game->snapshots);
+        ProfilerEnd(PROFILE_SNAPSHOT);
+    }
+}
 
+//gameplay state, main gameplay, every run starts here
+void EnterGameplay(Game &game) {
+    PlayMusicTrack(game.music, MUSIC_SOUNDTRACK, 0.2f);  // Adjust the volume as needed
 
-//MAIN
-int main() {
-    //window dimensions
-    const int screenWidth = 700;
-    const int screenHeight = 300;
+    //reset game variables
+    ResetGameSim(game.sim, game.assets);
+    ResetSimClock(game.simClock);
+    game.jumpRequested = false;
+    game.simEvents = 0;
 
-    //init window
-    InitWindow(screenWidth, screenHeight, "Mochi, Run!");
+    //first snapshot by hand, drawn until the thread publishes its own
+    InitSnapshotBuffer(game.snapshots);
+    CaptureSnapshot(SnapshotToWrite(game.snapshots), game.sim, game.simClock, TraceClock::now());
+    PublishSnapshot(game.snapshots);
+    game.snapshot = &AcquireSnapshot(game.snapshots);
 
-    //init audio
-    InitAudioDevice();
+    game.simRunning = true;
+    game.simThread = std::thread(RunSimulation, &game);
+}
 
-    //initialize game state to INTRO
-    GameState gameState = INTRO;
+void UpdateGameplay(Game &game) {
+    //delta time
+    const float dT{GetFrameTime()};
 
-    //initialize intro state time
-    double introTimer = GetTime();
-    //intro prompt animation
-    float minScale = 1.0f;
-    float maxScale = 1.15f;
-    float scaleSpeed = 0.3f;
-    float textScale = minScale;
-    bool scalingUp = true;
-
-    
-    //initialize countdown state time
-    double countdownTimer = GetTime();
-    //countdown timer var
-    int countdownValue = 4;
-    int fontSize = 60;
+    //jump on the next tick
+    if (IsKeyPressed(KEY_SPACE)) {
+        game.jumpRequested = true;
+    }
+    //newest finished simulation state
+    game.snapshot = &AcquireSnapshot(game.snapshots);
+    unsigned int frameEvents = game.simEvents.exchange(0);
+
+    //sound effects raised by the simulation
+    if (frameEvents & SIM_EVENT_JUMP) PlaySoundEffect(game.soundPool, SOUND_JUMP, game.currentTime);
+    if (frameEvents & SIM_EVENT_EAT) PlaySoundEffect(game.soundPool, SOUND_EAT, game.currentTime);
+    if (frameEvents & SIM_EVENT_IMPACT) PlaySoundEffect(game.soundPool, SOUND_IMPACT, game.currentTime);
+    if (game.snapshot->gameOver) {
+        SetGameState(game, GAMEOVER);
+    }
 
-    //initialize try again state
-    TryAgainState tryAgainState = YES;
-    bool tryAgainSelected = true;
-
-    //initialize the player score and game time
-    int playerScore = 0;
-    double gameTime = 0.0;
-
-    //initialize game velocity
-    int velocity{0};
-
-    //Mochi (player) properties
-    //Mochi texture (for intro)
-    Texture2D mochiIntroTexture = LoadTexture("textures/mochi_intro.png");
-    //Mochi textures (for gameplay)
-    Texture2D mochiTexture = LoadTexture("textures/mochi_running.png");
-    Texture2D mochiJumpTexture = LoadTexture("textures/mochi_jump.png");
-    //Mochi rec
-    Rectangle playerRect = { 150.0f, screenHeight - mochiTexture.height - 20.0f, mochiTexture.width / 4, mochiTexture.height };
-
-
-    //Mochi properties
-    AnimationData mochiData;
-    //texture
-    mochiData.rec.width = mochiTexture.width/4;
-    mochiData.rec.height = mochiTexture.height;
-    mochiData.rec.x = 0;
-    mochiData.rec.y = 0;
-    //pos
-    mochiData.pos.x = 150 - mochiData.rec.width/2;
-    mochiData.pos.y = screenHeight - mochiData.rec.height;
-    //animation
-    mochiData.frame = 0;
-    mochiData.updateTime = 1.0/16.0;
-    mochiData.runningTime = 0.0;
-
-    //gravity (pixel/frame/frame)/s
-    const int gravity{1'600};
-    //Mochi Air Bool
-    bool isInAir{};
-    //Mochi jump velocity 
-    const int jumpVelocity{-580};
-
-    //health pick up properties
-    ///health pick up textures
-    Texture2D healthPickupTexture = LoadTexture("textures/health.png");
-    //store health pick up array
-    const int maxHealthPickups = 10;
-    HealthPickup healthPickups[maxHealthPickups] = {0};
-    //init grace period
-    double gracePeriodRemaining = 0.0;
-    // Add a grace period timer
-    double gracePeriodTimer = 0.0;
-    //time before user | drone collision counts again (sec)
-    const double gracePeriodDuration = 1.5;
-    //initialize var to control the spawning of health
-    float healthSpawnTimer = 0.0f;
-    //before one spawns
-    float healthSpawnRate = 15.0f;
-    //alternate ground | air spawns
-    bool spawnOnGround = true;
-    
-    // Initialize the player's health system
-    HealthSystem playerHealth;
-    playerHealth.heartTexture = LoadTexture("textures/mochi_health.png");
-    playerHealth.maxHealth = 3;
-    playerHealth.currentHealth = 3;
-
-    //initialize drone types
-    Drone drones[4];
-    //drone 1
-    drones[0].texture = LoadTexture("textures/drone1.png");
-    drones[0].frameCount = 4;
-    drones[0].frameTime = 1.0 / 10.0;
-    //drone 2
-    drones[1].texture = LoadTexture("textures/drone2.png");
-    drones[1].frameCount = 8;
-    drones[1].frameTime = 1.0 / 15.0;
-    //drone 3
-    drones[2].texture = LoadTexture("textures/drone3.png");
-    drones[2].frameCount = 4;
-    drones[2].frameTime = 1.0 / 10.0;
-    //drone 4
-    drones[3].texture = LoadTexture("textures/drone4.png");
-    drones[3].frameCount = 4;
-    drones[3].frameTime = 1.0 / 10.0;
-
-    //collision box for drones
-    Rectangle droneCollisionRectangles[4];
-    for (int i = 0; i < 4; i++) {
-        droneCollisionRectangles[i] = (Rectangle){0};
-
-        //adjust width and height to make the collision box smaller
-        //multiplier for width size
-        droneCollisionRectangles[i].width = drones[i].texture.width / drones[i].frameCount * 0.5f;
-        //multiplier for height size
-        droneCollisionRectangles[i].height = drones[i].texture.height * 0.5f;
-    }
-
-    //enemy amount|frequency
-    //max on screen before despawn
-    const int maxEnemies = 10;
-    //store enemy instances
-    Enemy enemies[maxEnemies];
-    
-    //enemy spawn time (sec)
-    //ground enemies
-    const float minGroundEnemySpawnTime = 2.0f;  
-    const float maxGroundEnemySpawnTime = 8.0f;
-    //air enemy
-    const float minAirEnemySpawnTime = 8.0f;
-    const float maxAirEnemySpawnTime = 12.0f;
-    //ground and air enemy initial time spawn
-    float groundEnemySpawnTimer = 0.0f;
-    float airEnemySpawnTimer = 0.0f;
-
-    //player to enemy collision impact properties
-    ImpactAnimation impactAnim;
-    //texture
-    impactAnim.texture = LoadTexture("textures/impact.png");
-    //animation
-    impactAnim.frameCount = 8;
-    impactAnim.frameTime = 1.0 / 16.0;
-    impactAnim.currentFrame = 0;
-    impactAnim.frameTimer = 0.0;
-    //initialize impact animation pos, update this on collision
-    impactAnim.position = (Vector2){0, 0};
-    //default state
-    impactAnim.active = false;
-    
-    //background | foreground textures
-    Texture2D background = LoadTexture("textures/background.png");
-    Texture2D foreground = LoadTexture("textures/foreground.png");
-    //initialize parallax
-    float bgX{};
-    float fgX{};
-
-    //sounds
-    //jump sound
-    Sound jumpSound = LoadSound("sfx/jump.wav");
-    //impact sound
-    Sound impactSound = LoadSound("sfx/impact.wav");
-    //health pickup sound
-    Sound eatSound = LoadSound("sfx/eat.wav");
-    //intro alarm sound (intro)
-    Sound alarmSound = LoadSound("sfx/alarm.wav");
-    //angry cat meow sound (intro)
-    Sound angrySound = LoadSound("sfx/angry.wav");
-    //game over sound
-    Sound meowSound = LoadSound("sfx/meow.wav");
-
-    //music soundtrack
-    //intro
-    Music menuSong = LoadMusicStream("sfx/menu.ogg");
-    //gameplay
-    Music soundTrack = LoadMusicStream("sfx/soundtrack.ogg");
+    //background scroll, reset for infinite effect
+    ProfilerBegin(PROFILE_PARALLAX);
+    game.bgX -= 40 * dT;
+    if (game.bgX <= -game.atlas.sprites[SPRITE_BACKGROUND].width * 2.8f) {
+        game.bgX = 0.0f;
+    }
+    //foreground scroll
+    game.fgX -= 120 * dT;
+    if (game.fgX <= -game.atlas.sprites[SPRITE_FOREGROUND].width * 1.2f) {
+        game.fgX = 0.0f;
+    }
+    ProfilerEnd(PROFILE_PARALLAX);
+}
 
-    //FPS
-    SetTargetFPS(60);
-    //main window and game loop
-    while (!WindowShouldClose()) {
-        //update timer
-        double currentTime = GetTime();
-
-        //Switch game states
-        switch (gameState) {
-            //intro state
-            case INTRO: {
-                //intro song
-                SetMusicVolume(menuSong, 0.5f);
-                PlayMusicStream(menuSong);
-                UpdateMusicStream(menuSong);
-
-                //Calculate the elapsed time for the intro state
-                double introElapsed = GetTime() - introTimer;
-
-                // Check if the intro state has been running for less than 2 seconds
-                if (introElapsed < 2.0) {
-                    //
-                    DrawText("Made by Franz", screenWidth / 2 - MeasureText("Made by Franz", 40) / 2, screenHeight / 2 - 40, 40, SKYBLUE);
-                } else {
-                    //increases scale factor of prompt
-                    float scaleFactorBackground = 2.0;
-                    float scaleFactorForeground = 2.0;
-                    
-                    Vector2 bgPos;
-                    bgPos.x = 0;
-                    bgPos.y = screenHeight - background.height * scaleFactorBackground;
-                    DrawTextureEx(background, bgPos, 0.0, scaleFactorBackground, WHITE);
-
-                    //adjust the position foreground texture
-                    Vector2 fgPos;
-                    fgPos.x = -130; // Adjust the x-coordinate to move it horizontally
-                    fgPos.y = screenHeight - foreground.height * scaleFactorForeground; // Keep the same y-coordinate
-                    DrawTextureEx(foreground, fgPos, 0.0, scaleFactorForeground, WHITE);
-
-                    //draws the intro foreground
-                    Vector2 introPos = {10.0f, static_cast<float>(screenHeight - mochiIntroTexture.height - 10)};
-
-                    //draws the Mochi shadow (only in intro)
-                    Color shadowColor = (Color){0, 0, 0, 150}; // Adjust the alpha value for transparency
-                    Vector2 shadowCenter;
-                    shadowCenter.x = introPos.x + mochiIntroTexture.width / 2 - 115;
-                    shadowCenter.y = screenHeight - 20;
-                    int shadowWidth = mochiIntroTexture.width;
-                    int shadowHeight = 7;
-                    DrawEllipse((int)shadowCenter.x, (int)shadowCenter.y, shadowWidth, shadowHeight, shadowColor);
-                    //draws Mochi intro texture
-                    DrawTexture(mochiIntroTexture, (int)introPos.x, (int)introPos.y, RAYWHITE);
-
-                    //Title text
-                    //set outline color
-                    Color outlineColor = BLACK;
-                    //set the text color
-                    Color textColor = MAGENTA;
-                    //calculate the text width
-                    int textWidth = MeasureText("Mochi, Run!", 60);
-                    //gets the position of the text
-                    int textX = screenWidth / 2 - textWidth / 2;
-                    int textY = screenHeight / 2 - 40;
-                    //draws the text with an outline
-                    int outlineSize = 3;
-                    for (int i = -outlineSize; i <= outlineSize; i++) {
-                        for (int j = -outlineSize; j <= outlineSize; j++) {
-                            if (i != 0 || j != 0) {
-                                DrawText("Mochi, Run!", textX + i, textY + j, 60, outlineColor);
-                            }
-                        }
-                    }
-                    //draws the main text over the outline
-                    DrawText("Mochi, Run!", textX, textY, 60, textColor);
-                    //prompt bool animation
-                    if (scalingUp) {
-                        textScale += scaleSpeed * GetFrameTime();
-                        if (textScale >= maxScale) {
-                            scalingUp = false;
-                        }
-                    } else {
-                        textScale -= scaleSpeed * GetFrameTime();
-                        if (textScale <= minScale) {
-                            scalingUp = true;
-                        }
-                    }
-
-                    //draws the "Press [SPACE] to Start" text with the current scale
-                    DrawText("Press [SPACE] to START", (screenWidth - 355) - MeasureText("Press [SPACE] to START", 20 * textScale) / 2, screenHeight - 25, 20 * textScale, RAYWHITE);
-            
-                    //check for key press to transition to the countdown state
-                    if (IsKeyDown(KEY_SPACE)) {
-                        StopMusicStream(menuSong);
-                        gameState = COUNTDOWN;
-                    }
-
-                    //exit button (works throughout prog)
-                    if (IsKeyDown(KEY_ESCAPE)) {
-                        break;
-                        return 0;
-                    }
-                }
-                break;
-            }
+void DrawGameplay(Game &game) {
+    const TextureAtlas &atlas = game.atlas;
+    const RenderSnapshot &snapshot = *game.snapshot;
+    const Rectangle &background = atlas.sprites[SPRITE_BACKGROUND];
+    const Rectangle &foreground = atlas.sprites[SPRITE_FOREGROUND];
+    //blend factor between the snapshot's last two ticks for drawing
+    const float alpha = SnapshotAlpha(snapshot, TraceClock::now());
+
+    //draw backgrounds
+    ProfilerBegin(PROFILE_PARALLAX);
+    Vector2 bg1Pos{game.bgX, 0.0f};
+    DrawSpriteEx(atlas, SPRITE_BACKGROUND, bg1Pos, 2.8f, WHITE);
+    //second background, reset
+    Vector2 bg2Pos = {game.bgX + background.width * 2.8f, 0.0f};
+    DrawSpriteEx(atlas, SPRITE_BACKGROUND, bg2Pos, 2.8f, WHITE);
+
+    //draw foregrounds
+    Vector2 fg1Pos{game.fgX, -18.0f};
+    DrawSpriteEx(atlas, SPRITE_FOREGROUND, fg1Pos, 1.2f, WHITE);
+    //second foreground, reset
+    Vector2 fg2Pos = {game.fgX + foreground.width * 1.2f, -18.0f};
+    DrawSpriteEx(atlas, SPRITE_FOREGROUND, fg2Pos, 1.2f, WHITE);
+    ProfilerEnd(PROFILE_PARALLAX);
+
+    //draw Mochi, alternating running |  jumping textures
+    ProfilerBegin(PROFILE_SPRITE_DRAW);
+    Vector2 mochiPos = LerpPosition(snapshot.mochiPrevPos, snapshot.mochiPos, alpha);
+    const Rectangle &mochiRec = snapshot.mochiSource;
+    DrawSprite(atlas, snapshot.mochiInAir ? SPRITE_MOCHI_JUMP : SPRITE_MOCHI_RUNNING, mochiRec, (Rectangle){mochiPos.x, mochiPos.y, mochiRec.width, mochiRec.height}, WHITE);
+
+    //draws health pickups
+    for (int i = 0; i < snapshot.pickupCount; i++) {
+        Vector2 pickupPos = LerpPosition((Vector2){snapshot.pickupPrevX[i], snapshot.pickupPrevY[i]}, (Vector2){snapshot.pickupX[i], snapshot.pickupY[i]}, alpha);
+        DrawSpriteEx(atlas, SPRITE_HEALTH_PICKUP, pickupPos, 1.0f, WHITE);
+    }
 
-            //countdown state
-            case COUNTDOWN: {
-                //calculate countdown time
-                double countdownElapsed = currentTime - countdownTimer;
-                
-                //countdown greater than 1 sec
-                if (countdownElapsed >= 1.0) {
-                    countdownValue--;
-                    if (countdownValue >= 0) {
-                        countdownTimer = currentTime;
-                    }
-                }
+    ProfilerEnd(PROFILE_SPRITE_DRAW);
 
-                //delay before showing run text
-                double runDelayElapsed = countdownElapsed - 1;
-                double runDelay = 1.0;
-                
-                //countdown less than 0
-                if (countdownValue < 0) {
-                    //draws run text after countdonw
-                    if (runDelayElapsed < runDelay) {  
-                        DrawText("Run!", screenWidth / 2 - MeasureText("Run!", fontSize) / 2, screenHeight / 2 - fontSize / 2, fontSize, RED);
-                    } else {
-                        gameState = GAMEPLAY;
-
-                        //reset game variables
-                        mochiData.pos.x = 150 - mochiData.rec.width / 2;
-                        mochiData.pos.y = screenHeight - mochiData.rec.height;
-                        gameTime = 0.0;
-                        playerScore = 0;
-                        gracePeriodRemaining = 0.0;
-                        playerHealth.currentHealth = playerHealth.maxHealth;
-                        gracePeriodRemaining = 0.0;
-                        //enemy drones
-                        for (int i = 0; i < maxEnemies; i++) {
-                            enemies[i].active = false;
-                        }
-                        //health pickups
-                        for (int i = 0; i < maxHealthPickups; i++) {
-                            healthPickups[i].texture.id = 0;
-                        }
-                    }
-                    PlaySound(angrySound);
-                } else {
-                    //draws countdown
-                    DrawText(TextFormat("%d", countdownValue), screenWidth / 2 - MeasureText(TextFormat("%d", countdownValue), fontSize) / 2, screenHeight / 2 - fontSize / 2, fontSize, MAGENTA);
-                    PlaySound(alarmSound);
-                }
-                break;
-            }
+    //draws live enemies
+    ProfilerBegin(PROFILE_ENEMY_DRAW);
+    for (int i = 0; i < snapshot.enemyCount; i++) {
+        Vector2 enemyPos = LerpPosition((Vector2){snapshot.enemyPrevX[i], snapshot.enemyPrevY[i]}, (Vector2){snapshot.enemyX[i], snapshot.enemyY[i]}, alpha);
+        const Rectangle &frameRec = snapshot.enemySource[i];
 
-            //gameplay state, main gameplay
-            case GAMEPLAY: {
-                //sound control
-                SetMusicVolume(soundTrack, 0.2f);  // Adjust the volume as needed
-                PlayMusicStream(soundTrack);
-                UpdateMusicStream(soundTrack);
+        DrawSprite(atlas, (SpriteId)(SPRITE_DRONE1 + snapshot.enemyType[i]), frameRec,
+            (Rectangle) { enemyPos.x, enemyPos.y, frameRec.width, frameRec.height }, WHITE);
+    }
 
-                //delta time
-                const float dT{GetFrameTime()};
-                //game time | score
-                gameTime += GetFrameTime();
-                playerScore = (int)(gameTime * 1000);
+    ProfilerEnd(PROFILE_ENEMY_DRAW);
 
+    //draws playing impact explosions, then every particle as a solid square
+    //from the atlas (one texture, so it all stays in the sprite batch)
+    ProfilerBegin(PROFILE_EFFECT_DRAW);
+    for (int i = 0; i < snapshot.impactCount; i++) {
+        const Rectangle &frameRec = snapshot.impactSource[i];
+        DrawSprite(atlas, SPRITE_IMPACT, frameRec,
+            (Rectangle){snapshot.impactX[i], snapshot.impactY[i], frameRec.width, frameRec.height},
+            WHITE);
+    }
 
-                //background scroll, reset for infinite effect
-                bgX -= 40 * dT;
-                if (bgX <= -background.width * 2.8f) {
-                    bgX = 0.0f;
-                }
-                //foreground scroll
-                fgX -= 120 * dT;
-                if (fgX <= -foreground.width * 1.2f) {
-                    fgX = 0.0f;
-                }
+    for (int i = 0; i < snapshot.particleCount; i++) {
+        const ParticleEmitter &emitter = particleEmitters[snapshot.particleKind[i]];
+        Vector2 particlePos = LerpPosition((Vector2){snapshot.particlePrevX[i], snapshot.particlePrevY[i]}, (Vector2){snapshot.particleX[i], snapshot.particleY[i]}, alpha);
+        //fades out over its life
+        Color color = Fade(emitter.color, snapshot.particleLife[i] / snapshot.particleLifetime[i]);
+        DrawAtlasRectangle(atlas, (Rectangle){particlePos.x - emitter.size / 2, particlePos.y - emitter.size / 2, emitter.size, emitter.size}, color);
+    }
+    ProfilerEnd(PROFILE_EFFECT_DRAW);
+
+    //draws player health at the top left of the screen
+    ProfilerBegin(PROFILE_HUD);
+    DrawPlayerHealth(atlas, snapshot.playerHealth, snapshot.inGracePeriod);
+
+    //score (conversion)
+    int seconds = (int)snapshot.gameTime;
+    int tenthsOfASecond = (int)((snapshot.gameTime - seconds) * 10);
+    //draws the score in "000000" format (seconds then tenths)
+    DrawHudNumber(game.hud, HUD_SCORE, seconds * 10 + tenthsOfASecond, 6, screenWidth - 100, 10, MAGENTA);
+    ProfilerEnd(PROFILE_HUD);
+}
 
-                //draw backgrounds
-                Vector2 bg1Pos{bgX, 0.0f};
-                DrawTextureEx(background, bg1Pos, 0.0f, 2.8f, WHITE);
-                //second background, reset
-                Vector2 bg2Pos = {bgX + background.width * 2.8f, 0.0f};
-                DrawTextureEx(background, bg2Pos, 0.0f, 2.8f, WHITE);
-
-                //draw foregrounds
-                Vector2 fg1Pos{fgX, -18.0f};
-                DrawTextureEx(foreground, fg1Pos, 0.0f, 1.2f, WHITE);
-                //second foreground, reset
-                Vector2 fg2Pos = {fgX + foreground.width * 1.2f, -18.0f};
-                DrawTextureEx(foreground, fg2Pos, 0.0f, 1.2f, WHITE);
-
-                //Update mochi position
-                mochiData.pos.y += velocity * dT;
-
-                //update Mochi animation frame (not in air)
-                if (!isInAir) {
-                    mochiData = updateAnimData(mochiData, dT, 4);
-                }
+void ExitGameplay(Game &game) {
+    //wait for the simulation thread, sim is the main thread's again after this
+    game.simRunning = false;
+    game.simThread.join();
 
-                //Mochi ground check
-                if (isOnGround(mochiData, screenHeight)) {
-                    //Mochi on ground
-                    velocity = 0;
-                    isInAir = false;
-
-                    //set the Y position to the exact position of the ground after landing
-                    mochiData.pos.y = screenHeight - mochiData.rec.height; 
-                } else {
-                    //Mochi in air
-                    velocity += gravity * dT;
-                    isInAir = true;
-                }
-        
-                //jump check 
-                if (IsKeyPressed(KEY_SPACE) && !isInAir) {
-                    velocity += jumpVelocity;
-                    //use jump texture when jumping
-                    mochiData.rec.width = mochiJumpTexture.width / 4;
-                    //reset y pos
-                    mochiData.pos.y = screenHeight - mochiData.rec.height;
-
-                    PlaySound(jumpSound);
-                } else {
-                     //use running texture when not jumping
-                    mochiData.rec.width = mochiTexture.width / 4;
-                
-                }
+    //stops gameplay music
+    StopMusicTrack(game.music, MUSIC_SOUNDTRACK);
+}
 
-                //draw Mochi, alternating running |  jumping textures
-                DrawTextureRec(isInAir ? mochiJumpTexture : mochiTexture, mochiData.rec, mochiData.pos, WHITE);
-
-                //update health pickups time
-                healthSpawnTimer += GetFrameTime();
-                
-                //spawn health pickups
-                if (healthSpawnTimer >= healthSpawnRate) {
-                    //reset the spawn timer after initial
-                    healthSpawnTimer = 0.0f;
-
-                    //find an available health pickup slot in the array
-                    for (int i = 0; i < maxHealthPickups; i++) {
-                        if (healthPickups[i].texture.id == 0) {
-                            //initialize a new health pickup
-                            healthPickups[i].texture = healthPickupTexture;
-                            healthPickups[i].speed = 200;
-                            if (spawnOnGround) {
-                                //spawn on the ground
-                                healthPickups[i].position = (Vector2){screenWidth, screenHeight - (healthPickupTexture.height + 10)};
-                            } else {
-                                //spawn in the air
-                                healthPickups[i].position = (Vector2){screenWidth, screenHeight - (healthPickupTexture.height + 120)};
-                            }
-                            break;
-                        }
-                    }
-
-                    //randomize next spawn rate (15 | 30 seconds)
-                    healthSpawnRate = GetRandomValue(15, 30);
-                    //alternate between ground and air spawns
-                    spawnOnGround = !spawnOnGround;
-                }
+//game over state, score and the try again prompt
+void EnterGameOver(Game &game) {
+    //play meow sound
+    PlaySoundEffect(game.soundPool, SOUND_MEOW, game.currentTime);
+}
 
-                //update the position of active health pickups
-                for (int i = 0; i < maxHealthPickups; i++) {
-                    if (healthPickups[i].texture.id != 0) {
-                        healthPickups[i].position.x -= healthPickups[i].speed * GetFrameTime();
-                    }
-                }
+void UpdateGameOver(Game &game) {
+    //prompt keys this frame, from the keyboard or the replay
+    unsigned int menuInputs = 0;
+    if (game.replaying) {
+        TakeReplayInput(game.replay, game.simTick, replayMenuInputs, menuInputs);
+    } else {
+        if (IsKeyPressed(KEY_W)) menuInputs |= REPLAY_MENU_W;
+        if (IsKeyPressed(KEY_S)) menuInputs |= REPLAY_MENU_S;
+        if (IsKeyPressed(KEY_UP)) menuInputs |= REPLAY_MENU_UP;
+        if (IsKeyPressed(KEY_DOWN)) menuInputs |= REPLAY_MENU_DOWN;
+        if (IsKeyPressed(KEY_ENTER)) menuInputs |= REPLAY_MENU_ENTER;
+        WriteReplayInput(game.recorder, game.simTick, menuInputs);
+    }
 
-                //check for collisions with health pickups and collect them
-                for (int i = 0; i < maxHealthPickups; i++) {
-                    if (healthPickups[i].texture.id != 0) {
-                        if (CheckCollisionPlayerHealthPickup(mochiData, healthPickups[i])) {
-                            if (playerHealth.currentHealth < playerHealth.maxHealth) {
-                                //increase player's health by 1
-                                playerHealth.currentHealth++;
-
-                                //eat sound effect
-                                PlaySound(eatSound);
-                            }
-                            //set the health pickup invisible
-                            healthPickups[i].texture.id = 0;
-                        }
-                    }
-                }
+    //input handling, W (up) | S (down) on prompt
+    if (menuInputs & (REPLAY_MENU_W | REPLAY_MENU_UP)) {
+        game.tryAgainSelected = true;
+    } else if (menuInputs & (REPLAY_MENU_S | REPLAY_MENU_DOWN)) {
+        game.tryAgainSelected = false;
+    }
 
-                //draws health pickups
-                for (int i = 0; i < maxHealthPickups; i++) {
-                    if (healthPickups[i].texture.id != 0) {
-                        DrawTexture(healthPickupTexture, healthPickups[i].position.x, healthPickups[i].position.y, WHITE);
-                    }
-                }
+    //check for user input in prompt
+    if (menuInputs & REPLAY_MENU_W) {
+        game.tryAgainState = YES;
+    } else if (menuInputs & REPLAY_MENU_S) {
+        game.tryAgainState = NO;
+    } else if (menuInputs & REPLAY_MENU_ENTER) {
+        //try again yes, else return to the main menu or intro
+        SetGameState(game, game.tryAgainState == YES ? COUNTDOWN : INTRO);
+    }
+}
 
-                //checks for collisions player and enemy collsions during grace period
-                if (gracePeriodRemaining > 0.0) {
-                    gracePeriodRemaining -= GetFrameTime();
-                } else {
-                    for (int i = 0; i < maxEnemies; i++) {
-                        if (enemies[i].active) {
-                            if (CheckCollisionRecs(
-                                (Rectangle){mochiData.pos.x, mochiData.pos.y, mochiData.rec.width, mochiData.rec.height},
-                                (Rectangle){enemies[i].position.x, enemies[i].position.y, droneCollisionRectangles[3].width, droneCollisionRectangles[3].height})) {
-                                //out of lives
-                                if (playerHealth.currentHealth <= 0) {
-                                    gameState = GAMEOVER;
-
-                                    //play meow sound
-                                    PlaySound(meowSound);
-                                } else {
-                                    //decrease player health
-                                    PlaySound(impactSound);
-                                    playerHealth.currentHealth--;
-
-                                    //set the grace period remaining time to 1.5 sec
-                                    gracePeriodRemaining = gracePeriodDuration;
-
-                                    //update the impact animation position to the collision point
-                                    impactAnim.position = (Vector2){enemies[i].position.x, mochiData.pos.y};
-                                    impactAnim.active = true;
-
-                                    //turn the collided drone invisible
-                                    enemies[i].active = false;
-                                }
-                            }
-                        }
-                    }
-                }
-                //during impact, animation frames
-                if (impactAnim.active) {
-                    impactAnim.frameTimer += GetFrameTime();
-                    if (impactAnim.frameTimer >= impactAnim.frameTime) {
-                        impactAnim.frameTimer = 0.0;
-                        impactAnim.currentFrame++;
-                        //deactivate impact animation
-                        if (impactAnim.currentFrame >= impactAnim.frameCount) {
-                            impactAnim.currentFrame = 0;
-                            impactAnim.active = false;
-                        }
-                    }
-                }
+void DrawGameOver(Game &game) {
+    //grabs score thats converted
+    int seconds = (int)game.sim.gameTime;
+    int tenthsOfASecond = (int)((game.sim.gameTime - seconds) * 10);
+
+    //rebuild the screen text only when score or selection changed,
+    //nothing else is drawn before it this frame
+    long long gameOverKey = ((long long)seconds * 10 + tenthsOfASecond) * 2 + (game.tryAgainSelected ? 1 : 0);
+    if (UiLayerNeedsBuild(game.gameOverLayer, gameOverKey)) {
+        BeginUiLayer(game.gameOverLayer, gameOverKey);
+        //draws game over text
+        DrawText("Meow Over", screenWidth / 2 - MeasureText("Meow Over", 70) / 2, screenHeight / 2 - 130, 70, RED);
+        //draws score below game over text
+        DrawText(TextFormat("Score: %05d%01d", seconds, tenthsOfASecond), screenWidth / 2 - MeasureText("Score: 00000", 20) / 2, screenHeight / 2 - 40, 20, WHITE);
+        //draw try again prompt
+        DrawText("Try Again?", screenWidth / 2 - MeasureText("Try Again?", 20) / 2, screenHeight / 2 + 40, 25, WHITE);
+        //draws yes and no options with highlighitng
+        if (game.tryAgainSelected) {
+            //main selection yes
+            DrawText("> Yes <", screenWidth / 2 - MeasureText("> Yes <", 20) / 2, screenHeight / 2 + 80, 20, GREEN);
+            DrawText("No", screenWidth / 2 - MeasureText("No", 20) / 2, screenHeight / 2 + 110, 20, WHITE);
+        } else {
+            //main selection no
+            DrawText("Yes", screenWidth / 2 - MeasureText("Yes", 20) / 2, screenHeight / 2 + 80, 20, WHITE);
+            DrawText("> No <", screenWidth / 2 - MeasureText("> No <", 20) / 2, screenHeight / 2 + 110, 20, RED);
+        }
+        EndUiLayer();
+    }
+    DrawUiLayer(game.gameOverLayer, 0, 0, WHITE);
+}
 
-                //update enemy spawning timers
-                groundEnemySpawnTimer += GetFrameTime();
-
-                //spawns ground enemies randomly
-                if (groundEnemySpawnTimer >= GetRandomValue(minGroundEnemySpawnTime, maxGroundEnemySpawnTime)) {
-                    for (int i = 0; i < maxEnemies; i++) {
-                        if (!enemies[i].active) {
-                            int droneType = GetRandomValue(0, 2);
-                            enemies[i].texture = drones[droneType].texture;
-                            enemies[i].frameCount = drones[droneType].frameCount;
-                            enemies[i].frameTime = drones[droneType].frameTime;
-                            enemies[i].currentFrame = 0;
-                            enemies[i].frameTimer = 0.0f;
-
-                            //ground pos 1 (on ground)
-                            int groundPosition1 = screenHeight - enemies[i].texture.height;
-                            //ground pos 2 (slightly above)
-                            int groundPosition2 = screenHeight - enemies[i].texture.height - 45;
-                            //selected ground pos 1 or 2
-                            int selectedPosition = GetRandomValue(0, 1);
-                            
-                            if (selectedPosition == 0) {
-                                enemies[i].position = (Vector2){screenWidth, groundPosition1};
-                            } else {
-                                enemies[i].position = (Vector2){screenWidth, groundPosition2};
-                            }
-
-                            enemies[i].speed = GetRandomValue(400, 800);
-                            enemies[i].active = true;
-                            //reset ground enemy timer
-                            groundEnemySpawnTimer = 0.0f;
-                            break;
-                        }
-                    }
-                }
+//hooks of one state: enter | exit run once per transition, update | draw once per
+//frame, null when a state has nothing to do there
+struct GameStateHooks {
+    //for trace events
+    const char *name;
+    void (*enter)(Game &game);
+    void (*update)(Game &game);
+    void (*draw)(Game &game);
+    void (*exit)(Game &game);
+};
 
-                //updates enemy spawning timers
-                airEnemySpawnTimer += GetFrameTime();
-                //spawn air enemies randomly
-                if (airEnemySpawnTimer >= GetRandomValue(minAirEnemySpawnTime, maxAirEnemySpawnTime)) {
-                    for (int i = 0; i < maxEnemies; i++) {
-                        if (!enemies[i].active) {
-                            //uses only drone 4 texture
-                            enemies[i].texture = drones[3].texture;
-                            enemies[i].frameCount = drones[3].frameCount;
-                            enemies[i].currentFrame = 0;
-                            enemies[i].frameTimer = 0.0f;
-                            enemies[i].position = (Vector2) { screenWidth, (screenHeight - 145) - enemies[i].texture.height / 2 };
-                            enemies[i].speed = GetRandomValue(200, 300);
-                            enemies[i].active = true;
-                            airEnemySpawnTimer = 0.0f;
-                            break;
-                        }
-                    }
-                }
+//indexed by GameState
+const GameStateHooks gameStates[GAME_STATE_COUNT] = {
+    {"INTRO", EnterIntro, UpdateIntro, DrawIntro, ExitIntro},
+    {"COUNTDOWN", EnterCountdown, UpdateCountdown, DrawCountdown, nullptr},
+    {"GAMEPLAY", EnterGameplay, UpdateGameplay, DrawGameplay, ExitGameplay},
+    {"GAMEOVER", EnterGameOver, UpdateGameOver, DrawGameOver, nullptr}
+};
 
-                //update the position and animation frames of active enemies
-                for (int i = 0; i < maxEnemies; i++) {
-                    if (enemies[i].active) {
-                        enemies[i].position.x -= enemies[i].speed * GetFrameTime();
-                        
-                        //check if the enemy is out of the screen
-                        if (enemies[i].position.x + enemies[i].texture.width < 0) {
-                            enemies[i].active = false;
-                        }
-
-                        enemies[i].frameTimer += GetFrameTime();
-                        if (enemies[i].frameTimer >= enemies[i].frameTime) {
-                            enemies[i].frameTimer = 0.0f;
-                            enemies[i].currentFrame++;
-                            if (enemies[i].currentFrame >= enemies[i].frameCount) {
-                                enemies[i].currentFrame = 0;
-                            }
-                        }
-                    }
-                }
+//make state current, run its enter hook and mark the transition in the trace
+void EnterGameState(Game &game, GameState state) {
+    game.state = state;
+    game.nextState = state;
+    TraceInstant(gameStates[state].name, "state");
+    if (gameStates[state].enter) {
+        gameStates[state].enter(game);
+    }
+}
 
-                //draws active enemies
-                for (int i = 0; i < maxEnemies; i++) {
-                    if (enemies[i].active) {
-                        if (enemies[i].frameCount > 0) {
-                            float frameWidth = static_cast<float>(enemies[i].texture.width) / enemies[i].frameCount;
-                            float frameHeight = static_cast<float>(enemies[i].texture.height);
-
-                            DrawTexturePro(enemies[i].texture,
-                                (Rectangle) { static_cast<float>(enemies[i].currentFrame) * frameWidth, 0, frameWidth, frameHeight },
-                                (Rectangle) { static_cast<float>(enemies[i].position.x), static_cast<float>(enemies[i].position.y), frameWidth, frameHeight }, Vector2{ 0, 0 }, 0, WHITE);
-                        }
-                    }
-                }
+//switch to the state the update asked for, if any
+void ChangeGameState(Game &game) {
+    if (game.nextState == game.state) {
+        return;
+    }
+    ProfilerBegin(PROFILE_STATE_CHANGE);
+    if (gameStates[game.state].exit) {
+        gameStates[game.state].exit(game);
+    }
+    EnterGameState(game, game.nextState);
+    ProfilerEnd(PROFILE_STATE_CHANGE);
+}
 
-                //draws impact animation if it's active
-                if (impactAnim.active) {
-                    float frameWidth = (float)impactAnim.texture.width / impactAnim.frameCount;
-                    float frameHeight = (float)impactAnim.texture.height;
-            
-                    //draws the current frame of the impact animation at its position
-                    DrawTexturePro(impactAnim.texture,
-                        (Rectangle){(float)impactAnim.currentFrame * frameWidth, 0, frameWidth, frameHeight},
-                        (Rectangle){impactAnim.position.x, impactAnim.position.y, frameWidth, frameHeight},
-                        Vector2{0, 0},
-                        0,
-                        WHITE);
-                }
+//MAIN
+int main(int argc, char *argv[]) {
+    //time to first frame | time to interactive count from here
+    const TraceClock::time_point startupTime = TraceClock::now();
+
+    //command line options
+    GameOptions options;
+    ParseGameOptions(argc, argv, options);
+    if (options.simdLevel >= 0) {
+        SetSimdLevel((SimdLevel)options.simdLevel);
+    }
 
-                //draws player health at the top left of the screen
-                DrawPlayerHealth(playerHealth, gracePeriodRemaining > 0.0);
+    //run gameplay ticks without a window when requested
+    if (options.headless) {
+        return RunHeadless(options);
+    }
+    if (options.replayPath && options.replayFast) {
+        return RunReplayFast(options);
+    }
 
-                //score (conversion)
-                int seconds = (int)gameTime;
-                int tenthsOfASecond = (int)((gameTime - seconds) * 10);
-                //draws the scorein "00000" format
-                DrawText(TextFormat("%05d%01d", seconds, tenthsOfASecond), screenWidth - 100, 10, 20, MAGENTA);
-                break;
-            }
+    //shared by every state, large, so not on the stack
+    static Game game;
+    game.options = &options;
+    game.startupTime = startupTime;
+
+    //1x replay, the recording decides seed and tick rate
+    game.replaying = false;
+    if (options.replayPath) {
+        game.replaying = OpenReplayReader(game.replay, options.replayPath);
+        if (game.replaying) {
+            options.seed = game.replay.header.seed;
+            options.tickRate = game.replay.header.tickRate;
+        } else {
+            TraceLog(LOG_WARNING, "REPLAY: could not read %s", options.replayPath);
+        }
+    }
 
-            //game over state
-            case GAMEOVER: {
-                //stops gameplay music
-                StopMusicStream(soundTrack);
-
-                //reset the player's position after death 
-                velocity = 0;
-                isInAir = false;
-
-                //draws game over text
-                DrawText("Meow Over", screenWidth / 2 - MeasureText("Meow Over", 70) / 2, screenHeight / 2 - 130, 70, RED);
-
-                //grabs score thats converted
-                int seconds = (int)gameTime;
-                int tenthsOfASecond = (int)((gameTime - seconds) * 10);
-                //draws score below game over text
-                DrawText(TextFormat("Score: %05d%01d", seconds, tenthsOfASecond), screenWidth / 2 - MeasureText("Score: 00000", 20) / 2, screenHeight / 2 - 40, 20, WHITE);
-
-                //draw try again prompt
-                DrawText("Try Again?", screenWidth / 2 - MeasureText("Try Again?", 20) / 2, screenHeight / 2 + 40, 25, WHITE);
-                //input handling, W (up) | S (down) on prompt
-                if (IsKeyPressed(KEY_W) || IsKeyPressed(KEY_UP)) {
-                    tryAgainSelected = true;
-                } else if (IsKeyPressed(KEY_S) || IsKeyPressed(KEY_DOWN)) {
-                    tryAgainSelected = false;
-                }
-                //draws yes and no options with highlighitng
-                if (tryAgainSelected) {
-                    //main selection yes
-                    DrawText("> Yes <", screenWidth / 2 - MeasureText("> Yes <", 20) / 2, screenHeight / 2 + 80, 20, GREEN);
-                    DrawText("No", screenWidth / 2 - MeasureText("No", 20) / 2, screenHeight / 2 + 110, 20, WHITE);
-                } else {
-                    //main selection no
-                    DrawText("Yes", screenWidth / 2 - MeasureText("Yes", 20) / 2, screenHeight / 2 + 80, 20, WHITE);
-                    DrawText("> No <", screenWidth / 2 - MeasureText("> No <", 20) / 2, screenHeight / 2 + 110, 20, RED);
-                }
-                //check for user input in prompt
-                if (IsKeyPressed(KEY_W)) {
-                    tryAgainState = YES;
-                } else if (IsKeyPressed(KEY_S)) {
-                    tryAgainState = NO;
-                } else if (IsKeyPressed(KEY_ENTER)) {
-                    //try again yes
-                    if (tryAgainState == YES) {
-                       //reset game variables
-                        gameState = COUNTDOWN;
-                        countdownTimer = GetTime();
-                        countdownValue = 3;
-                        gameTime = 0.0;
-                        playerScore = 0;
-                        playerHealth.currentHealth = playerHealth.maxHealth;
-                        gracePeriodRemaining = 0.0;
-                        //reset the player position
-                        mochiData.pos.x = 150 - mochiData.rec.width / 2;
-                        mochiData.pos.y = screenHeight - mochiData.rec.height;
-                        //clear out enemy and health pickup data
-                        for (int i = 0; i < maxEnemies; i++) {
-                            enemies[i].active = false;
-                        }
-                        for (int i = 0; i < maxHealthPickups; i++) {
-                            healthPickups[i].texture.id = 0;
-                        }
-                        // Reset the impact animation
-                        impactAnim.active = false;
-                    //try again no
-                    } else if (tryAgainState == NO) {
-                        //return to the main menu or intro
-                        //reset intro timer
-                        countdownTimer = GetTime();
-                        countdownValue = 3;
-                        gameState = INTRO;
-                    }
+    //timing events for trace viewers, opened first so asset loads are included
+    if (options.tracePath && !OpenTrace(options.tracePath)) {
+        TraceLog(LOG_WARNING, "TRACE: could not create %s", options.tracePath);
+    }
+
+    //init window
+    InitWindow(screenWidth, screenHeight, "Mochi, Run!");
+
+    //init audio
+    InitAudioDevice();
+
+    //baked assets when there is an up to date pack, else the loose files
+    AssetPack assetPack;
+    if (OpenAssetPack(assetPack, assetPackFile)) {
+        SetActiveAssetPack(&assetPack);
+        ReportStartup("asset pack mapped", startupTime);
+    }
+
+    //sprite sheets and sounds decode on worker threads while the intro runs
+    StartAssetLoader(game.loader, GetActiveAssetPack());
+
+    //initialize intro state time
+    game.introTimer = GetTime();
+    game.currentTime = game.introTimer;
+    //intro prompt animation
+    game.textScale = promptMinScale;
+    game.scalingUp = true;
+
+    //countdown, set on entering it
+    game.countdownTimer = game.introTimer;
+    game.countdownValue = countdownStart;
+
+    //initialize try again state
+    game.tryAgainState = YES;
+    game.tryAgainSelected = true;
+
+    //static text, laid out once instead of measured every frame
+    game.madeByX = screenWidth / 2 - MeasureText("Made by Franz", 40) / 2;
+    game.runTextX = screenWidth / 2 - MeasureText("Run!", fontSize) / 2;
+    //the start prompt pulses between a few integer font sizes, measure each one
+    for (int i = 0; i < promptSizeCount; i++) {
+        game.promptWidths[i] = MeasureText("Press [SPACE] to START", promptMinSize + i);
+    }
+
+    //outlined title (49 text draws) rendered once
+    LoadUiLayer(game.titleLayer, screenWidth, screenHeight);
+    BeginUiLayer(game.titleLayer, 0);
+    {
+        //Title text
+        //set outline color
+        Color outlineColor = BLACK;
+        //set the text color
+        Color textColor = MAGENTA;
+        //calculate the text width
+        int textWidth = MeasureText("Mochi, Run!", 60);
+        //gets the position of the text
+        int textX = screenWidth / 2 - textWidth / 2;
+        int textY = screenHeight / 2 - 40;
+        //draws the text with an outline
+        int outlineSize = 3;
+        for (int i = -outlineSize; i <= outlineSize; i++) {
+            for (int j = -outlineSize; j <= outlineSize; j++) {
+                if (i != 0 || j != 0) {
+                    DrawText("Mochi, Run!", textX + i, textY + j, 60, outlineColor);
                 }
-                break;
             }
         }
+        //draws the main text over the outline
+        DrawText("Mochi, Run!", textX, textY, 60, textColor);
+    }
+    EndUiLayer();
+    LoadUiLayer(game.gameOverLayer, screenWidth, screenHeight);
+
+    //atlas, sounds and gameplay state come from the loader
+    game.atlas = {};
+    for (int i = 0; i < SOUND_COUNT; i++) {
+        game.sounds[i] = {};
+    }
+    game.soundPool = {};
+    game.assetsReady = false;
+    bool firstFrameShown = false;
+    LoadHudDigits(game.hud);
+
+    //fixed rate simulation clock, independent of the render rate
+    InitSimClock(game.simClock, options.tickRate);
+    game.hashLog = options.hashLogPath ? fopen(options.hashLogPath, "w") : nullptr;
+    game.simTick = 0;
+
+    game.recorder = {};
+    if (!game.replaying && options.recordPath && options.stressCount > 0) {
+        TraceLog(LOG_WARNING, "REPLAY: --stress runs are not recorded");
+    } else if (!game.replaying && options.recordPath) {
+        ReplayHeader header = {options.seed, options.tickRate};
+        if (!OpenReplayWriter(game.recorder, options.recordPath, header)) {
+            TraceLog(LOG_WARNING, "REPLAY: could not create %s", options.recordPath);
+        }
+    }
+
+    //initialize parallax
+    game.bgX = 0.0f;
+    game.fgX = 0.0f;
+
+    //menu song and soundtrack, refilled on their own thread from here on
+    LoadMusicPlayer(game.music, GetActiveAssetPack());
+
+    //initialize game state to INTRO
+    EnterGameState(game, INTRO);
+
+    //FPS
+    SetTargetFPS(60);
+    //main window and game loop
+    while (!WindowShouldClose()) {
+        ProfilerBeginFrame();
+
+        //update timer
+        game.currentTime = GetTime();
+
+        //frame profiler overlay
+        if (IsKeyPressed(KEY_F3)) {
+            ToggleProfiler();
+        }
+
+        FinishGameAssets(game);
+
+        //replay reached the point the recording was closed (during gameplay the
+        //simulation thread checks)
+        if (game.state != GAMEPLAY && game.replaying && game.assetsReady) {
+            CheckReplayFinished(game.replay, game.replaying, game.simTick, game.sim);
+        }
+
+        //current state, then the one it switched to draws this frame
+        gameStates[game.state].update(game);
+        ChangeGameState(game);
+        gameStates[game.state].draw(game);
+
+        //per-phase timings, below the health hearts
+        DrawProfilerOverlay(10, 40);
+
+        ProfilerBegin(PROFILE_PRESENT);
         BeginDrawing();
         ClearBackground(BLACK);
         EndDrawing();
+        ProfilerEnd(PROFILE_PRESENT);
+        if (!firstFrameShown) {
+            firstFrameShown = true;
+            ReportStartup("first frame", startupTime);
+        }
+
+        ProfilerEndFrame();
     }
-    //unload textures
-    //mochi
-    UnloadTexture(mochiIntroTexture);
-    UnloadTexture(mochiTexture);
-    UnloadTexture(mochiJumpTexture);
-    //health
-    UnloadTexture(healthPickupTexture);
-    //background | foreground
-    UnloadTexture(background);
-    UnloadTexture(foreground);
-    
-    //unloading all drone textures
-    for (int i = 0; i < 4; i++) {
-        UnloadTexture(drones[i].texture);
-    }
-
-    //unload the sound
-    UnloadSound(jumpSound);
-    UnloadSound(impactSound);
-    UnloadSound(eatSound);
-    UnloadSound(alarmSound);
-    UnloadSound(meowSound);
-    UnloadSound(angrySound);
-
-    //unload music
-    UnloadMusicStream(menuSong);
-    UnloadMusicStream(soundTrack);
+    //leave the current state, stops the simulation thread if the window closed mid-run
+    if (gameStates[game.state].exit) {
+        gameStates[game.state].exit(game);
+    }
+    //workers may still be decoding if the window closed during the intro
+    StopAssetLoader(game.loader);
+
+    //unload textures, every sprite lives in the atlas
+    UnloadTextureAtlas(game.atlas);
+    UnloadHudDigits(game.hud);
+    UnloadUiLayer(game.titleLayer);
+    UnloadUiLayer(game.gameOverLayer);
+
+    //unload the sound, aliases first
+    UnloadSoundPool(game.soundPool);
+    for (int i = 0; i < SOUND_COUNT; i++) {
+        UnloadSound(game.sounds[i]);
+    }
+
+    //unload music, stops its thread
+    UnloadMusicPlayer(game.music);
+
+    //streams and uploads are done with the mapping
+    CloseAssetPack(assetPack);
+
+    if (game.hashLog) {
+        fclose(game.hashLog);
+    }
+    //end record carries the final hash so playback can verify itself
+    CloseReplayWriter(game.recorder, game.simTick, game.assetsReady ? HashGameSim(game.sim) : 0);
+
+    //flush the remaining trace events
+    CloseTrace();
 
     //close window and audio
     CloseAudioDevice();
     CloseWindow();
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,86 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Music player
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#include <chrono>
+#include "MusicPlayer.h"
+#include "Trace.h"
+
+//refill whatever plays until told to stop
+static void MusicThread(MusicPlayer *player) {
+    std::unique_lock<std::mutex> hold(player->lock);
+    while (player->running) {
+        for (int i = 0; i < MUSIC_COUNT; i++) {
+            if (player->playing[i]) {
+                UpdateMusicStream(player->tracks[i]);
+            }
+        }
+        player->wake.wait_for(hold, std::chrono::milliseconds(musicRefillMs));
+    }
+}
+
+void LoadMusicPlayer(MusicPlayer &player, const AssetPack *pack) {
+    for (int i = 0; i < MUSIC_COUNT; i++) {
+        TraceClock::time_point start = TraceClock::now();
+        const AssetPackEntry *entry = pack ? FindAssetPackEntry(*pack, musicFiles[i], PACK_BLOB) : nullptr;
+        const unsigned char *data = nullptr;
+        int size = 0;
+        player.fileData[i] = nullptr;
+        if (entry) {
+            data = AssetPackData(*pack, *entry);
+            size = (int)entry->size;
+        } else {
+            player.fileData[i] = LoadFileData(musicFiles[i], &size);
+            data = player.fileData[i];
+        }
+        player.tracks[i] = data ? LoadMusicStreamFromMemory(GetFileExtension(musicFiles[i]), data, size) : (Music){0};
+        player.playing[i] = false;
+        TraceComplete(musicFiles[i], "asset", start, TraceClock::now());
+    }
+
+    player.running = true;
+    player.thread = std::thread(MusicThread, &player);
+}
+
+void PlayMusicTrack(MusicPlayer &player, MusicId track, float volume) {
+    std::lock_guard<std::mutex> hold(player.lock);
+    if (player.playing[track]) {
+        return;
+    }
+    SetMusicVolume(player.tracks[track], volume);
+    PlayMusicStream(player.tracks[track]);
+    player.playing[track] = true;
+    TraceInstant(musicFiles[track], "audio");
+}
+
+void StopMusicTrack(MusicPlayer &player, MusicId track) {
+    std::lock_guard<std::mutex> hold(player.lock);
+    if (!player.playing[track]) {
+        return;
+    }
+    StopMusicStream(player.tracks[track]);
+    player.playing[track] = false;
+}
+
+void UnloadMusicPlayer(MusicPlayer &player) {
+    {
+        std::lock_guard<std::mutex> hold(player.lock);
+        player.running = false;
+    }
+    player.wake.notify_one();
+    if (player.thread.joinable()) {
+        player.thread.join();
+    }
+
+    for (int i = 0; i < MUSIC_COUNT; i++) {
+        UnloadMusicStream(player.tracks[i]);
+        UnloadFileData(player.fileData[i]);
+        player.tracks[i] = (Music){0};
+        player.fileData[i] = nullptr;
+        player.playing[i] = false;
+    }
+}
@@ -0,0 +1,48 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Music player
+*
+*   Owns the music streams and keeps their buffers filled from a thread of its own, so a
+*   long frame (asset upload, hitch) never lets the music run dry. Each file is read once:
+*   from the asset pack mapping when there is one, else into memory at load, and the
+*   streams decode from those bytes instead of going back to disk. The main thread only
+*   says which track plays.
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#ifndef MOCHI_MUSIC_PLAYER_H
+#define MOCHI_MUSIC_PLAYER_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "raylib.h"
+#include "AssetLoader.h"
+
+//how often the music thread refills, well under one stream buffer (~1/30 s)
+const int musicRefillMs = 10;
+
+struct MusicPlayer {
+    Music tracks[MUSIC_COUNT];
+    //file bytes a stream decodes from when it is not in the pack, freed on unload
+    unsigned char *fileData[MUSIC_COUNT];
+    bool playing[MUSIC_COUNT];
+    //guards tracks | playing, held by the music thread while it refills
+    std::mutex lock;
+    std::condition_variable wake;
+    bool running;
+    std::thread thread;
+};
+
+//load every track (from pack when it has them, it must stay open until unload) and
+//start the music thread, needs the audio device
+void LoadMusicPlayer(MusicPlayer &player, const AssetPack *pack);
+//start track at volume unless it already plays, cheap enough to call every frame
+void PlayMusicTrack(MusicPlayer &player, MusicId track, float volume);
+void StopMusicTrack(MusicPlayer &player, MusicId track);
+//stop the music thread and unload the tracks
+void UnloadMusicPlayer(MusicPlayer &player);
+
+#endif
@@ -0,0 +1,72 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Command line options
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include "Effects.h"
+#include "Options.h"
+#include "SimdKernels.h"
+
+void ParseGameOptions(int argc, char *argv[], GameOptions &options) {
+    //defaults
+    options.headless = false;
+    options.headlessTicks = 0;
+    options.tickRate = 120;
+    options.seed = (uint64_t)time(nullptr);
+    options.hashLogPath = nullptr;
+    options.recordPath = nullptr;
+    options.replayPath = nullptr;
+    options.replayFast = false;
+    options.tracePath = nullptr;
+    options.simdLevel = -1;
+    options.stressCount = 0;
+    options.particleCapacity = defaultParticleCapacity;
+
+    for (int i = 1; i < argc; i++) {
+        //options that take a value
+        bool hasValue = i + 1 < argc;
+
+        if (strcmp(argv[i], "--headless") == 0 && hasValue) {
+            options.headless = true;
+            options.headlessTicks = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--tick-rate") == 0 && hasValue) {
+            options.tickRate = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && hasValue) {
+            options.seed = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--hash-log") == 0 && hasValue) {
+            options.hashLogPath = argv[++i];
+        } else if (strcmp(argv[i], "--record") == 0 && hasValue) {
+            options.recordPath = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && hasValue) {
+            options.replayPath = argv[++i];
+        } else if (strcmp(argv[i], "--trace") == 0 && hasValue) {
+            options.tracePath = argv[++i];
+        } else if (strcmp(argv[i], "--simd") == 0 && hasValue) {
+            const char *level = argv[++i];
+            for (int l = SIMD_SCALAR; l <= SIMD_AVX2; l++) {
+                if (strcmp(level, SimdLevelName((SimdLevel)l)) == 0) {
+                    options.simdLevel = l;
+                }
+            }
+        } else if (strcmp(argv[i], "--stress") == 0 && hasValue) {
+            options.stressCount = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--particles") == 0 && hasValue) {
+            options.particleCapacity = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--fast") == 0) {
+            options.replayFast = true;
+        }
+    }
+
+    //keep the tick rate sane
+    if (options.tickRate < 10) options.tickRate = 10;
+    if (options.tickRate > 1000) options.tickRate = 1000;
+    if (options.stressCount < 0) options.stressCount = 0;
+    if (options.particleCapacity < 0) options.particleCapacity = 0;
+    if (options.particleCapacity > maxParticleCapacity) options.particleCapacity = maxParticleCapacity;
+}
@@ -0,0 +1,44 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Command line options
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#ifndef MOCHI_OPTIONS_H
+#define MOCHI_OPTIONS_H
+
+#include <cstdint>
+
+//launch settings, filled from the command line
+struct GameOptions {
+    //run gameplay ticks with no window (--headless <ticks>)
+    bool headless;
+    long long headlessTicks;
+    //fixed simulation rate in ticks per second (--tick-rate <hz>)
+    int tickRate;
+    //spawn RNG seed (--seed <n>), taken from the clock when not given
+    uint64_t seed;
+    //per-tick state hash output (--hash-log <file>), null when off
+    const char *hashLogPath;
+    //record jump | menu inputs to a replay file (--record <file>)
+    const char *recordPath;
+    //play a replay back instead of the keyboard (--replay <file>)
+    const char *replayPath;
+    //replay with no window as fast as the CPU allows (--fast)
+    bool replayFast;
+    //timing events as Chrome trace JSON, or CSV for a .csv name (--trace <file>)
+    const char *tracePath;
+    //entity kernel level (--simd scalar|sse2|avx2), -1 picks the best the CPU has
+    int simdLevel;
+    //stress mode with this many drones and pickups (--stress <n>), 0 when off
+    int stressCount;
+    //particle pool size (--particles <n>), up to maxParticleCapacity
+    int particleCapacity;
+};
+
+//parse argv into options, unknown arguments are ignored
+void ParseGameOptions(int argc, char *argv[], GameOptions &options);
+
+#endif
@@ -0,0 +1,159 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Frame profiler
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include "raylib.h"
+#include "Profiler.h"
+#include "Trace.h"
+
+//same clock as the trace so both line up
+typedef TraceClock ProfileClock;
+
+//phase names for the overlay
+static const char *phaseNames[PROFILE_PHASE_COUNT] = {
+    "state change",
+    "parallax",
+    "mochi update",
+    "spawns",
+    "pickups",
+    "enemy update",
+    "broadphase",
+    "effects",
+    "snapshot",
+    "mochi/pickup draw",
+    "enemy draw",
+    "effect draw",
+    "hud",
+    "present"
+};
+
+//ring buffer of per-frame timings in ms, the last column is the frame total.
+//Simulation phases run on the simulation thread: each phase is only ever begun | ended
+//by one thread, and the running totals are atomic (ns) so both threads can add to them
+struct ProfilerState {
+    std::atomic<bool> enabled;
+    ProfileClock::time_point frameStart;
+    ProfileClock::time_point phaseStart[PROFILE_PHASE_COUNT];
+    std::atomic<long long> current[PROFILE_PHASE_COUNT];
+    float history[profilerFrames][PROFILE_PHASE_COUNT + 1];
+    int head;
+    int filled;
+};
+
+static ProfilerState profiler;
+
+void ToggleProfiler() {
+    profiler.enabled = !profiler.enabled;
+    //start over so stale frames do not skew the numbers
+    profiler.head = 0;
+    profiler.filled = 0;
+    ProfilerBeginFrame();
+}
+
+bool IsProfilerEnabled() {
+    return profiler.enabled;
+}
+
+void ProfilerBeginFrame() {
+    if (!profiler.enabled && !IsTraceEnabled()) return;
+
+    profiler.frameStart = ProfileClock::now();
+    for (int i = 0; i < PROFILE_PHASE_COUNT; i++) {
+        profiler.current[i] = 0;
+    }
+}
+
+void ProfilerEndFrame() {
+    if (!profiler.enabled && !IsTraceEnabled()) return;
+
+    ProfileClock::time_point frameEnd = ProfileClock::now();
+    TraceComplete("frame", "frame", profiler.frameStart, frameEnd);
+    if (!profiler.enabled) return;
+
+    float *row = profiler.history[profiler.head];
+    for (int i = 0; i < PROFILE_PHASE_COUNT; i++) {
+        row[i] = (float)(profiler.current[i].load() / 1.0e6);
+    }
+    row[PROFILE_PHASE_COUNT] = (float)std::chrono::duration<double, std::milli>(frameEnd - profiler.frameStart).count();
+
+    profiler.head = (profiler.head + 1) % profilerFrames;
+    if (profiler.filled < profilerFrames) {
+        profiler.filled++;
+    }
+}
+
+void ProfilerBegin(ProfilePhase phase) {
+    if (!profiler.enabled && !IsTraceEnabled()) return;
+    profiler.phaseStart[phase] = ProfileClock::now();
+}
+
+void ProfilerEnd(ProfilePhase phase) {
+    if (!profiler.enabled && !IsTraceEnabled()) return;
+
+    ProfileClock::time_point phaseEnd = ProfileClock::now();
+    TraceComplete(phaseNames[phase], "phase", profiler.phaseStart[phase], phaseEnd);
+    if (!profiler.enabled) return;
+    profiler.current[phase] += std::chrono::duration_cast<std::chrono::nanoseconds>(phaseEnd - profiler.phaseStart[phase]).count();
+}
+
+//min | avg | p99 of one column over the filled frames
+static void ProfilerStats(int column, float &min, float &avg, float &p99) {
+    float values[profilerFrames];
+    float sum = 0.0f;
+    for (int i = 0; i < profiler.filled; i++) {
+        values[i] = profiler.history[i][column];
+        sum += values[i];
+    }
+    int p99Index = (profiler.filled * 99) / 100;
+    if (p99Index >= profiler.filled) p99Index = profiler.filled - 1;
+    std::nth_element(values, values + p99Index, values + profiler.filled);
+
+    p99 = values[p99Index];
+    min = *std::min_element(values, values + profiler.filled);
+    avg = sum / profiler.filled;
+}
+
+void DrawProfilerOverlay(int x, int y) {
+    if (!profiler.enabled || profiler.filled == 0) return;
+
+    const int fontSize = 10;
+    const int lineHeight = 11;
+    const int width = 250;
+    const int graphHeight = 40;
+    const int height = (PROFILE_PHASE_COUNT + 2) * lineHeight + graphHeight + 8;
+
+    DrawRectangle(x, y, width, height, (Color){0, 0, 0, 180});
+
+    int lineY = y + 2;
+    DrawText(TextFormat("last %d frames (ms)     min    avg    p99", profiler.filled), x + 4, lineY, fontSize, YELLOW);
+    lineY += lineHeight;
+
+    float min, avg, p99;
+    for (int i = 0; i <= PROFILE_PHASE_COUNT; i++) {
+        ProfilerStats(i, min, avg, p99);
+        const char *name = i < PROFILE_PHASE_COUNT ? phaseNames[i] : "frame total";
+        Color color = i < PROFILE_PHASE_COUNT ? RAYWHITE : YELLOW;
+        DrawText(name, x + 4, lineY, fontSize, color);
+        DrawText(TextFormat("%6.3f %6.3f %6.3f", min, avg, p99), x + 130, lineY, fontSize, color);
+        lineY += lineHeight;
+    }
+
+    //frame-time graph, oldest on the left, 33 ms at full height
+    const float graphScale = graphHeight / 33.3f;
+    int graphY = lineY + 2;
+    DrawLine(x + 4, graphY + graphHeight - (int)(16.7f * graphScale), x + 4 + profilerFrames, graphY + graphHeight - (int)(16.7f * graphScale), DARKGRAY);
+    for (int i = 0; i < profiler.filled; i++) {
+        int index = (profiler.head - profiler.filled + i + profilerFrames) % profilerFrames;
+        float frameMs = profiler.history[index][PROFILE_PHASE_COUNT];
+        int barHeight = std::min(graphHeight, (int)(frameMs * graphScale));
+        Color color = frameMs > 17.5f ? RED : LIME;
+        DrawLine(x + 4 + i, graphY + graphHeight, x + 4 + i, graphY + graphHeight - barHeight, color);
+    }
+}
@@ -0,0 +1,54 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Frame profiler
+*
+*   Opt-in per-phase timings of the main loop kept in a fixed-size ring buffer, shown as an
+*   overlay with min | avg | p99 over the last frames and a frame-time graph (toggle F3).
+*   Phases are also exported as trace events while a trace is open (see Trace.h).
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#ifndef MOCHI_PROFILER_H
+#define MOCHI_PROFILER_H
+
+//sections of main() that get timed
+enum ProfilePhase {
+    PROFILE_STATE_CHANGE,
+    PROFILE_PARALLAX,
+    PROFILE_MOCHI_UPDATE,
+    PROFILE_SPAWNS,
+    PROFILE_PICKUPS,
+    PROFILE_ENEMY_UPDATE,
+    PROFILE_BROADPHASE,
+    PROFILE_EFFECTS,
+    PROFILE_SNAPSHOT,
+    PROFILE_SPRITE_DRAW,
+    PROFILE_ENEMY_DRAW,
+    PROFILE_EFFECT_DRAW,
+    PROFILE_HUD,
+    PROFILE_PRESENT,
+    PROFILE_PHASE_COUNT
+};
+
+//frames kept for the statistics and the graph
+const int profilerFrames = 240;
+
+//overlay on | off, timing calls cost one branch while off
+void ToggleProfiler();
+bool IsProfilerEnabled();
+
+//frame boundaries, the time in between is the frame total
+void ProfilerBeginFrame();
+void ProfilerEndFrame();
+
+//time spent between begin and end adds to the phase (a phase may run several
+//times a frame, e.g. once per simulation tick)
+void ProfilerBegin(ProfilePhase phase);
+void ProfilerEnd(ProfilePhase phase);
+
+//draw the phase table and frame-time graph at x, y
+void DrawProfilerOverlay(int x, int y);
+
+#endif
@@ -0,0 +1,58 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Random numbers
+*
+*   Small seedable PCG32 generator owned by the game, so runs with the same seed
+*   (and the same input) spawn exactly the same drones and pickups.
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#ifndef MOCHI_RANDOM_H
+#define MOCHI_RANDOM_H
+
+#include <cstdint>
+
+//PCG32 state (O'Neill, pcg-random.org)
+struct Rng {
+    uint64_t state;
+    uint64_t inc;
+};
+
+//next 32 random bits
+inline uint32_t RngNext(Rng &rng) {
+    uint64_t oldState = rng.state;
+    rng.state = oldState * 6364136223846793005ULL + rng.inc;
+    uint32_t xorShifted = (uint32_t)(((oldState >> 18u) ^ oldState) >> 27u);
+    uint32_t rot = (uint32_t)(oldState >> 59u);
+    return (xorShifted >> rot) | (xorShifted << ((32 - rot) & 31));
+}
+
+//start the sequence for seed
+inline void RngSeed(Rng &rng, uint64_t seed) {
+    rng.state = 0;
+    rng.inc = (seed << 1u) | 1u;
+    RngNext(rng);
+    rng.state += seed;
+    RngNext(rng);
+}
+
+//random int in [min, max], both inclusive like GetRandomValue
+inline int RngRange(Rng &rng, int min, int max) {
+    if (min > max) {
+        int swap = min;
+        min = max;
+        max = swap;
+    }
+    uint32_t range = (uint32_t)(max - min) + 1u;
+    //multiply-shift keeps the bias negligible for the small ranges used here
+    return min + (int)(((uint64_t)RngNext(rng) * range) >> 32);
+}
+
+//random float in [min, max), 24 random bits so every value is exact
+inline float RngFloat(Rng &rng, float min, float max) {
+    return min + (max - min) * ((RngNext(rng) >> 8) * (1.0f / 16777216.0f));
+}
+
+#endif
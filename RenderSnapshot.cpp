@@ -0,0 +1,96 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Render snapshots
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#include <algorithm>
+#include "RenderSnapshot.h"
+
+void InitSnapshotBuffer(SnapshotBuffer &buffer) {
+    buffer.writing = 0;
+    buffer.ready = 1;
+    buffer.reading = 2;
+    for (RenderSnapshot &snapshot : buffer.slots) {
+        snapshot.pickupCount = 0;
+        snapshot.enemyCount = 0;
+        snapshot.impactCount = 0;
+        snapshot.particleCount = 0;
+    }
+}
+
+//first count values of source, assign keeps the capacity so steady state never allocates
+template <typename T>
+static void CopyLive(std::vector<T> &destination, const std::vector<T> &source, int count) {
+    destination.assign(source.begin(), source.begin() + count);
+}
+
+void CaptureSnapshot(RenderSnapshot &snapshot, const GameSim &sim, const SimClock &clock, TraceClock::time_point now) {
+    snapshot.accumulator = clock.accumulator;
+    snapshot.tickDt = clock.tickDt;
+    snapshot.captured = now;
+
+    snapshot.mochiPrevPos = sim.mochiPrevPos;
+    snapshot.mochiPos = sim.mochiData.pos;
+    snapshot.mochiSource = sim.mochiAnimation.source[0];
+    snapshot.mochiInAir = sim.isInAir;
+    snapshot.playerHealth = sim.playerHealth;
+    snapshot.inGracePeriod = sim.gracePeriodRemaining > 0.0;
+    snapshot.gameTime = sim.gameTime;
+    snapshot.gameOver = sim.gameOver;
+
+    const PickupStore &pickups = sim.healthPickups;
+    snapshot.pickupCount = pickups.count;
+    CopyLive(snapshot.pickupPrevX, pickups.prevX, pickups.count);
+    CopyLive(snapshot.pickupPrevY, pickups.prevY, pickups.count);
+    CopyLive(snapshot.pickupX, pickups.x, pickups.count);
+    CopyLive(snapshot.pickupY, pickups.y, pickups.count);
+
+    const EnemyStore &enemies = sim.enemies;
+    snapshot.enemyCount = enemies.count;
+    CopyLive(snapshot.enemyPrevX, enemies.prevX, enemies.count);
+    CopyLive(snapshot.enemyPrevY, enemies.prevY, enemies.count);
+    CopyLive(snapshot.enemyX, enemies.x, enemies.count);
+    CopyLive(snapshot.enemyY, enemies.y, enemies.count);
+    CopyLive(snapshot.enemyType, enemies.type, enemies.count);
+    CopyLive(snapshot.enemySource, enemies.animation.source, enemies.count);
+
+    const ImpactEffects &impacts = sim.impacts;
+    snapshot.impactCount = impacts.count;
+    CopyLive(snapshot.impactX, impacts.x, impacts.count);
+    CopyLive(snapshot.impactY, impacts.y, impacts.count);
+    CopyLive(snapshot.impactSource, impacts.animation.source, impacts.count);
+
+    const ParticleStore &particles = sim.particles;
+    snapshot.particleCount = particles.count;
+    CopyLive(snapshot.particlePrevX, particles.prevX, particles.count);
+    CopyLive(snapshot.particlePrevY, particles.prevY, particles.count);
+    CopyLive(snapshot.particleX, particles.x, particles.count);
+    CopyLive(snapshot.particleY, particles.y, particles.count);
+    CopyLive(snapshot.particleLife, particles.life, particles.count);
+    CopyLive(snapshot.particleLifetime, particles.lifetime, particles.count);
+    CopyLive(snapshot.particleKind, particles.kind, particles.count);
+}
+
+RenderSnapshot &SnapshotToWrite(SnapshotBuffer &buffer) {
+    return buffer.slots[buffer.writing];
+}
+
+void PublishSnapshot(SnapshotBuffer &buffer) {
+    //the slot given back is either the previous unread one or one the renderer let go of
+    buffer.writing = buffer.ready.exchange(buffer.writing | snapshotFresh) & ~snapshotFresh;
+}
+
+const RenderSnapshot &AcquireSnapshot(SnapshotBuffer &buffer) {
+    if (buffer.ready.load() & snapshotFresh) {
+        buffer.reading = buffer.ready.exchange(buffer.reading) & ~snapshotFresh;
+    }
+    return buffer.slots[buffer.reading];
+}
+
+float SnapshotAlpha(const RenderSnapshot &snapshot, TraceClock::time_point now) {
+    double since = std::chrono::duration<double>(now - snapshot.captured).count();
+    return (float)std::min(1.0, std::max(0.0, (snapshot.accumulator + since) / snapshot.tickDt));
+}
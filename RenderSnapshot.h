@@ -0,0 +1,98 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Render snapshots
+*
+*   Gameplay runs on a simulation thread of its own. After its ticks it copies what the
+*   gameplay draw needs (positions before | after the last tick, animation frames, HUD
+*   values) into a snapshot and publishes it through a triple buffer: one snapshot being
+*   written, one being drawn and the newest finished one in between, handed over by
+*   swapping indices, so neither thread ever waits for the other and drawing never reads
+*   the live GameSim.
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#ifndef MOCHI_RENDER_SNAPSHOT_H
+#define MOCHI_RENDER_SNAPSHOT_H
+
+#include <atomic>
+#include <vector>
+#include "raylib.h"
+#include "Simulation.h"
+#include "Trace.h"
+
+struct RenderSnapshot {
+    //sim time not yet ticked | tick length | when it was taken, for the blend factor
+    double accumulator;
+    float tickDt;
+    TraceClock::time_point captured;
+
+    //Mochi and the HUD
+    Vector2 mochiPrevPos;
+    Vector2 mochiPos;
+    Rectangle mochiSource;
+    bool mochiInAir;
+    HealthSystem playerHealth;
+    bool inGracePeriod;
+    double gameTime;
+    bool gameOver;
+
+    //live health pickups
+    int pickupCount;
+    std::vector<float> pickupPrevX;
+    std::vector<float> pickupPrevY;
+    std::vector<float> pickupX;
+    std::vector<float> pickupY;
+
+    //live drones
+    int enemyCount;
+    std::vector<float> enemyPrevX;
+    std::vector<float> enemyPrevY;
+    std::vector<float> enemyX;
+    std::vector<float> enemyY;
+    std::vector<int> enemyType;
+    std::vector<Rectangle> enemySource;
+
+    //playing impact explosions
+    int impactCount;
+    std::vector<float> impactX;
+    std::vector<float> impactY;
+    std::vector<Rectangle> impactSource;
+
+    //live particles
+    int particleCount;
+    std::vector<float> particlePrevX;
+    std::vector<float> particlePrevY;
+    std::vector<float> particleX;
+    std::vector<float> particleY;
+    std::vector<float> particleLife;
+    std::vector<float> particleLifetime;
+    std::vector<unsigned char> particleKind;
+};
+
+//set in SnapshotBuffer::ready while the renderer has not taken that snapshot
+const int snapshotFresh = 4;
+
+struct SnapshotBuffer {
+    RenderSnapshot slots[3];
+    //newest published slot (| snapshotFresh), the only index both threads touch
+    std::atomic<int> ready;
+    //slot the simulation thread fills | slot the render thread draws
+    int writing;
+    int reading;
+};
+
+void InitSnapshotBuffer(SnapshotBuffer &buffer);
+//copy the live entities out of sim, only the live ones, reusing the slot's memory
+void CaptureSnapshot(RenderSnapshot &snapshot, const GameSim &sim, const SimClock &clock, TraceClock::time_point now);
+//simulation thread: slot to capture into, then hand it over (it replaces a published
+//snapshot the renderer has not taken yet)
+RenderSnapshot &SnapshotToWrite(SnapshotBuffer &buffer);
+void PublishSnapshot(SnapshotBuffer &buffer);
+//render thread: newest published snapshot, stays valid until the next acquire
+const RenderSnapshot &AcquireSnapshot(SnapshotBuffer &buffer);
+//blend factor between the snapshot's last two ticks at time now (0..1)
+float SnapshotAlpha(const RenderSnapshot &snapshot, TraceClock::time_point now);
+
+#endif
@@ -0,0 +1,185 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Replays
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#include <cstring>
+#include "Replay.h"
+
+static const char replayMagic[4] = {'M', 'R', 'P', 'L'};
+static const int replayVersion = 1;
+
+static void FlushReplayWriter(ReplayWriter &writer) {
+    if (writer.used > 0) {
+        fwrite(writer.buffer, 1, writer.used, writer.file);
+        writer.used = 0;
+    }
+}
+
+static void WriteReplayBytes(ReplayWriter &writer, const void *data, int size) {
+    if (writer.used + size > (int)sizeof(writer.buffer)) {
+        FlushReplayWriter(writer);
+    }
+    memcpy(writer.buffer + writer.used, data, size);
+    writer.used += size;
+}
+
+//little endian, independent of the host
+static void WriteReplayUint(ReplayWriter &writer, uint64_t value, int size) {
+    unsigned char bytes[8];
+    for (int i = 0; i < size; i++) {
+        bytes[i] = (unsigned char)(value >> (8 * i));
+    }
+    WriteReplayBytes(writer, bytes, size);
+}
+
+//7 bits per byte, most tick gaps fit in one or two bytes
+static void WriteReplayVarint(ReplayWriter &writer, uint64_t value) {
+    unsigned char bytes[10];
+    int size = 0;
+    do {
+        unsigned char byte = value & 0x7f;
+        value >>= 7;
+        bytes[size++] = byte | (value ? 0x80 : 0);
+    } while (value);
+    WriteReplayBytes(writer, bytes, size);
+}
+
+bool OpenReplayWriter(ReplayWriter &writer, const char *fileName, ReplayHeader header) {
+    writer.file = fopen(fileName, "wb");
+    writer.used = 0;
+    writer.lastTick = 0;
+    if (!writer.file) {
+        return false;
+    }
+
+    WriteReplayBytes(writer, replayMagic, sizeof(replayMagic));
+    WriteReplayUint(writer, replayVersion, 2);
+    WriteReplayUint(writer, header.tickRate, 2);
+    WriteReplayUint(writer, header.seed, 8);
+    return true;
+}
+
+void WriteReplayInput(ReplayWriter &writer, long long tick, unsigned int inputs) {
+    if (!writer.file || inputs == 0) {
+        return;
+    }
+    WriteReplayVarint(writer, tick - writer.lastTick);
+    WriteReplayUint(writer, inputs & 0xff, 1);
+    writer.lastTick = tick;
+}
+
+void CloseReplayWriter(ReplayWriter &writer, long long finalTick, uint64_t finalHash) {
+    if (!writer.file) {
+        return;
+    }
+    WriteReplayVarint(writer, finalTick - writer.lastTick);
+    WriteReplayUint(writer, REPLAY_END, 1);
+    WriteReplayUint(writer, finalHash, 8);
+    FlushReplayWriter(writer);
+    fclose(writer.file);
+    writer.file = nullptr;
+}
+
+static bool ReadReplayUint(ReplayReader &reader, int size, uint64_t &value) {
+    if (reader.offset + size > reader.data.size()) {
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i < size; i++) {
+        value |= (uint64_t)reader.data[reader.offset++] << (8 * i);
+    }
+    return true;
+}
+
+static bool ReadReplayVarint(ReplayReader &reader, uint64_t &value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (reader.offset >= reader.data.size()) {
+            return false;
+        }
+        unsigned char byte = reader.data[reader.offset++];
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//decode the next record into reader.next*
+static void AdvanceReplayReader(ReplayReader &reader) {
+    uint64_t delta = 0;
+    uint64_t inputs = 0;
+    reader.hasNext = ReadReplayVarint(reader, delta) && ReadReplayUint(reader, 1, inputs);
+    if (!reader.hasNext) {
+        return;
+    }
+    reader.nextTick = reader.lastTick + (long long)delta;
+    reader.nextInputs = (unsigned int)inputs;
+    reader.lastTick = reader.nextTick;
+
+    if (reader.nextInputs & REPLAY_END) {
+        uint64_t hash = 0;
+        ReadReplayUint(reader, 8, hash);
+        reader.endHash = hash;
+    }
+}
+
+bool OpenReplayReader(ReplayReader &reader, const char *fileName) {
+    reader.data.clear();
+    reader.offset = 0;
+    reader.lastTick = 0;
+    reader.hasNext = false;
+    reader.endHash = 0;
+
+    FILE *file = fopen(fileName, "rb");
+    if (!file) {
+        return false;
+    }
+    unsigned char chunk[4096];
+    size_t read = 0;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        reader.data.insert(reader.data.end(), chunk, chunk + read);
+    }
+    fclose(file);
+
+    //header
+    uint64_t version = 0;
+    uint64_t tickRate = 0;
+    uint64_t seed = 0;
+    if (reader.data.size() < sizeof(replayMagic) || memcmp(reader.data.data(), replayMagic, sizeof(replayMagic)) != 0) {
+        return false;
+    }
+    reader.offset = sizeof(replayMagic);
+    if (!ReadReplayUint(reader, 2, version) || version != replayVersion ||
+        !ReadReplayUint(reader, 2, tickRate) || !ReadReplayUint(reader, 8, seed)) {
+        return false;
+    }
+    reader.header.tickRate = (int)tickRate;
+    reader.header.seed = seed;
+
+    AdvanceReplayReader(reader);
+    return true;
+}
+
+bool TakeReplayInput(ReplayReader &reader, long long tick, unsigned int mask, unsigned int &inputs) {
+    inputs = 0;
+    if (!reader.hasNext || reader.nextTick != tick || !(reader.nextInputs & mask)) {
+        return false;
+    }
+    inputs = reader.nextInputs;
+    AdvanceReplayReader(reader);
+    return true;
+}
+
+bool ReplayFinished(const ReplayReader &reader, long long tick) {
+    //a truncated file ends wherever its records run out
+    if (!reader.hasNext) {
+        return true;
+    }
+    return (reader.nextInputs & REPLAY_END) && tick >= reader.nextTick;
+}
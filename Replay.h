@@ -0,0 +1,76 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Replays
+*
+*   Compact binary recording of player input stamped with simulation ticks.
+*
+*   File layout:
+*       "MRPL"  u16 version  u16 tickRate  u64 seed
+*       records: varint tickDelta, u8 inputs
+*       end:     varint tickDelta, u8 REPLAY_END, u64 final state hash
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#ifndef MOCHI_REPLAY_H
+#define MOCHI_REPLAY_H
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+//recorded inputs, jump is stamped with the tick it fed, menu keys with the
+//tick count at which the GAMEOVER prompt was showing
+enum ReplayInput {
+    REPLAY_JUMP = 1 << 0,
+    REPLAY_MENU_W = 1 << 1,
+    REPLAY_MENU_S = 1 << 2,
+    REPLAY_MENU_UP = 1 << 3,
+    REPLAY_MENU_DOWN = 1 << 4,
+    REPLAY_MENU_ENTER = 1 << 5,
+    REPLAY_END = 1 << 7
+};
+
+const unsigned int replayMenuInputs = REPLAY_MENU_W | REPLAY_MENU_S | REPLAY_MENU_UP | REPLAY_MENU_DOWN | REPLAY_MENU_ENTER;
+
+//what a replay needs to reproduce the run
+struct ReplayHeader {
+    uint64_t seed;
+    int tickRate;
+};
+
+//buffered streaming writer, flushes to disk only when the buffer fills
+struct ReplayWriter {
+    FILE *file;
+    unsigned char buffer[4096];
+    int used;
+    long long lastTick;
+};
+
+//whole replay held in memory, records decoded one at a time
+struct ReplayReader {
+    ReplayHeader header;
+    std::vector<unsigned char> data;
+    size_t offset;
+    long long lastTick;
+    //next record not yet taken
+    long long nextTick;
+    unsigned int nextInputs;
+    bool hasNext;
+    //hash stored with the end record
+    uint64_t endHash;
+};
+
+bool OpenReplayWriter(ReplayWriter &writer, const char *fileName, ReplayHeader header);
+void WriteReplayInput(ReplayWriter &writer, long long tick, unsigned int inputs);
+//write the end record and close, finalHash lets playback verify the result
+void CloseReplayWriter(ReplayWriter &writer, long long finalTick, uint64_t finalHash);
+
+bool OpenReplayReader(ReplayReader &reader, const char *fileName);
+//take the next record when it is stamped tick and carries any input in mask
+bool TakeReplayInput(ReplayReader &reader, long long tick, unsigned int mask, unsigned int &inputs);
+//true once playback reached the tick the recording ended on
+bool ReplayFinished(const ReplayReader &reader, long long tick);
+
+#endif
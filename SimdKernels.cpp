@@ -0,0 +1,474 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - SIMD entity kernels
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#include <cmath>
+#include "SimdKernels.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MOCHI_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+//scalar versions, also used for the tail that does not fill a whole vector
+static void AdvancePositionsScalar(float *x, const float *speed, int count, float dT) {
+    for (int i = 0; i < count; i++) {
+        x[i] -= speed[i] * dT;
+    }
+}
+
+static int StepAnimationTimersScalar(float *timer, const float *frameTime, int count, float dT, int *dueIndices) {
+    int found = 0;
+    for (int i = 0; i < count; i++) {
+        timer[i] += dT;
+        if (timer[i] >= frameTime[i]) {
+            timer[i] = 0.0f;
+            dueIndices[found++] = i;
+        }
+    }
+    return found;
+}
+
+static int StepParticlesScalar(float *x, float *y, const float *vx, float *vy, float *life, int count, float gravity, float dT, int *expired) {
+    const float fall = gravity * dT;
+    int found = 0;
+    for (int i = 0; i < count; i++) {
+        x[i] += vx[i] * dT;
+        y[i] += vy[i] * dT;
+        vy[i] += fall;
+        life[i] -= dT;
+        if (life[i] <= 0.0f) {
+            expired[found++] = i;
+        }
+    }
+    return found;
+}
+
+static int FindOffscreenScalar(const float *x, const float *width, int count, int *indices) {
+    int found = 0;
+    for (int i = 0; i < count; i++) {
+        if (x[i] + width[i] < 0) {
+            indices[found++] = i;
+        }
+    }
+    return found;
+}
+
+static int FindOffscreenUniformScalar(const float *x, float width, int count, int *indices) {
+    int found = 0;
+    for (int i = 0; i < count; i++) {
+        if (x[i] + width < 0) {
+            indices[found++] = i;
+        }
+    }
+    return found;
+}
+
+//one scalar box test, the vector versions use it for their tail
+static inline bool AabbOverlap(AabbBox box, float x, float y, float width, float height) {
+    return box.x < x + width && box.x + box.width > x && box.y < y + height && box.y + box.height > y;
+}
+
+static int CollideAabbsScalar(AabbBox box, const float *x, const float *y, const float *boxX, const float *boxY, const float *boxWidth, const float *boxHeight, int count, uint64_t *hitMask) {
+    for (int word = 0; word < (count + 63) / 64; word++) {
+        hitMask[word] = 0;
+    }
+    int hits = 0;
+    for (int i = 0; i < count; i++) {
+        if (AabbOverlap(box, x[i] + boxX[i], y[i] + boxY[i], boxWidth[i], boxHeight[i])) {
+            hitMask[i / 64] |= 1ULL << (i % 64);
+            hits++;
+        }
+    }
+    return hits;
+}
+
+static void SweepIntervalsScalar(const float *previous, const float *current, const float *size, int count, float *sweptMin, float *sweptSize) {
+    for (int i = 0; i < count; i++) {
+        sweptMin[i] = current[i] < previous[i] ? current[i] : previous[i];
+        sweptSize[i] = size[i] + fabsf(current[i] - previous[i]);
+    }
+}
+
+#ifdef MOCHI_SIMD_X86
+
+//append the set bits of a compare mask as indices starting at base
+static inline int AppendMaskIndices(unsigned int mask, int base, int *indices, int found) {
+    while (mask) {
+        indices[found++] = base + __builtin_ctz(mask);
+        mask &= mask - 1;
+    }
+    return found;
+}
+
+//SSE2, 4 lanes
+__attribute__((target("sse2")))
+static void AdvancePositionsSse2(float *x, const float *speed, int count, float dT) {
+    const __m128 dt = _mm_set1_ps(dT);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 step = _mm_mul_ps(_mm_loadu_ps(speed + i), dt);
+        _mm_storeu_ps(x + i, _mm_sub_ps(_mm_loadu_ps(x + i), step));
+    }
+    AdvancePositionsScalar(x + i, speed + i, count - i, dT);
+}
+
+__attribute__((target("sse2")))
+static int StepAnimationTimersSse2(float *timer, const float *frameTime, int count, float dT, int *dueIndices) {
+    const __m128 dt = _mm_set1_ps(dT);
+    int found = 0;
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 next = _mm_add_ps(_mm_loadu_ps(timer + i), dt);
+        //lanes whose frame is due go back to 0
+        __m128 due = _mm_cmpge_ps(next, _mm_loadu_ps(frameTime + i));
+        _mm_storeu_ps(timer + i, _mm_andnot_ps(due, next));
+        found = AppendMaskIndices(_mm_movemask_ps(due), i, dueIndices, found);
+    }
+    int tail = StepAnimationTimersScalar(timer + i, frameTime + i, count - i, dT, dueIndices + found);
+    for (int j = found; j < found + tail; j++) {
+        dueIndices[j] += i;
+    }
+    return found + tail;
+}
+
+__attribute__((target("sse2")))
+static int StepParticlesSse2(float *x, float *y, const float *vx, float *vy, float *life, int count, float gravity, float dT, int *expired) {
+    const __m128 dt = _mm_set1_ps(dT);
+    const __m128 fall = _mm_set1_ps(gravity * dT);
+    const __m128 zero = _mm_setzero_ps();
+    int found = 0;
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 velocityY = _mm_loadu_ps(vy + i);
+        _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(_mm_loadu_ps(vx + i), dt)));
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(velocityY, dt)));
+        _mm_storeu_ps(vy + i, _mm_add_ps(velocityY, fall));
+        __m128 left = _mm_sub_ps(_mm_loadu_ps(life + i), dt);
+        _mm_storeu_ps(life + i, left);
+        found = AppendMaskIndices(_mm_movemask_ps(_mm_cmple_ps(left, zero)), i, expired, found);
+    }
+    int tail = StepParticlesScalar(x + i, y + i, vx + i, vy + i, life + i, count - i, gravity, dT, expired + found);
+    for (int j = found; j < found + tail; j++) {
+        expired[j] += i;
+    }
+    return found + tail;
+}
+
+__attribute__((target("sse2")))
+static int FindOffscreenSse2(const float *x, const float *width, int count, int *indices) {
+    const __m128 zero = _mm_setzero_ps();
+    int found = 0;
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 right = _mm_add_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(width + i));
+        unsigned int mask = _mm_movemask_ps(_mm_cmplt_ps(right, zero));
+        found = AppendMaskIndices(mask, i, indices, found);
+    }
+    for (; i < count; i++) {
+        if (x[i] + width[i] < 0) {
+            indices[found++] = i;
+        }
+    }
+    return found;
+}
+
+__attribute__((target("sse2")))
+static int FindOffscreenUniformSse2(const float *x, float width, int count, int *indices) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 w = _mm_set1_ps(width);
+    int found = 0;
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        unsigned int mask = _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(_mm_loadu_ps(x + i), w), zero));
+        found = AppendMaskIndices(mask, i, indices, found);
+    }
+    for (; i < count; i++) {
+        if (x[i] + width < 0) {
+            indices[found++] = i;
+        }
+    }
+    return found;
+}
+
+__attribute__((target("sse2")))
+static int CollideAabbsSse2(AabbBox box, const float *x, const float *y, const float *boxX, const float *boxY, const float *boxWidth, const float *boxHeight, int count, uint64_t *hitMask) {
+    for (int word = 0; word < (count + 63) / 64; word++) {
+        hitMask[word] = 0;
+    }
+    const __m128 left = _mm_set1_ps(box.x);
+    const __m128 right = _mm_set1_ps(box.x + box.width);
+    const __m128 top = _mm_set1_ps(box.y);
+    const __m128 bottom = _mm_set1_ps(box.y + box.height);
+    int hits = 0;
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 otherLeft = _mm_add_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(boxX + i));
+        __m128 otherTop = _mm_add_ps(_mm_loadu_ps(y + i), _mm_loadu_ps(boxY + i));
+        __m128 otherRight = _mm_add_ps(otherLeft, _mm_loadu_ps(boxWidth + i));
+        __m128 otherBottom = _mm_add_ps(otherTop, _mm_loadu_ps(boxHeight + i));
+        __m128 overlap = _mm_and_ps(_mm_and_ps(_mm_cmplt_ps(left, otherRight), _mm_cmpgt_ps(right, otherLeft)),
+                                    _mm_and_ps(_mm_cmplt_ps(top, otherBottom), _mm_cmpgt_ps(bottom, otherTop)));
+        unsigned int mask = _mm_movemask_ps(overlap);
+        //4 lanes never straddle a 64-bit word
+        hitMask[i / 64] |= (uint64_t)mask << (i % 64);
+        hits += __builtin_popcount(mask);
+    }
+    for (; i < count; i++) {
+        if (AabbOverlap(box, x[i] + boxX[i], y[i] + boxY[i], boxWidth[i], boxHeight[i])) {
+            hitMask[i / 64] |= 1ULL << (i % 64);
+            hits++;
+        }
+    }
+    return hits;
+}
+
+__attribute__((target("sse2")))
+static void SweepIntervalsSse2(const float *previous, const float *current, const float *size, int count, float *sweptMin, float *sweptSize) {
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 before = _mm_loadu_ps(previous + i);
+        __m128 after = _mm_loadu_ps(current + i);
+        _mm_storeu_ps(sweptMin + i, _mm_min_ps(after, before));
+        _mm_storeu_ps(sweptSize + i, _mm_add_ps(_mm_loadu_ps(size + i), _mm_andnot_ps(signBit, _mm_sub_ps(after, before))));
+    }
+    SweepIntervalsScalar(previous + i, current + i, size + i, count - i, sweptMin + i, sweptSize + i);
+}
+
+//AVX2, 8 lanes (no FMA on purpose, a fused multiply-add would round differently from scalar)
+__attribute__((target("avx2")))
+static void AdvancePositionsAvx2(float *x, const float *speed, int count, float dT) {
+    const __m256 dt = _mm256_set1_ps(dT);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 step = _mm256_mul_ps(_mm256_loadu_ps(speed + i), dt);
+        _mm256_storeu_ps(x + i, _mm256_sub_ps(_mm256_loadu_ps(x + i), step));
+    }
+    //every AVX2 kernel leaves with clean upper halves (also before the SSE-encoded scalar
+    //tail), otherwise the next SSE code pays the AVX-SSE transition stall
+    _mm256_zeroupper();
+    AdvancePositionsScalar(x + i, speed + i, count - i, dT);
+}
+
+__attribute__((target("avx2")))
+static int StepAnimationTimersAvx2(float *timer, const float *frameTime, int count, float dT, int *dueIndices) {
+    const __m256 dt = _mm256_set1_ps(dT);
+    int found = 0;
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 next = _mm256_add_ps(_mm256_loadu_ps(timer + i), dt);
+        __m256 due = _mm256_cmp_ps(next, _mm256_loadu_ps(frameTime + i), _CMP_GE_OQ);
+        _mm256_storeu_ps(timer + i, _mm256_andnot_ps(due, next));
+        found = AppendMaskIndices(_mm256_movemask_ps(due), i, dueIndices, found);
+    }
+    _mm256_zeroupper();
+    int tail = StepAnimationTimersScalar(timer + i, frameTime + i, count - i, dT, dueIndices + found);
+    for (int j = found; j < found + tail; j++) {
+        dueIndices[j] += i;
+    }
+    return found + tail;
+}
+
+__attribute__((target("avx2")))
+static int StepParticlesAvx2(float *x, float *y, const float *vx, float *vy, float *life, int count, float gravity, float dT, int *expired) {
+    const __m256 dt = _mm256_set1_ps(dT);
+    const __m256 fall = _mm256_set1_ps(gravity * dT);
+    const __m256 zero = _mm256_setzero_ps();
+    int found = 0;
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 velocityY = _mm256_loadu_ps(vy + i);
+        _mm256_storeu_ps(x + i, _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_mul_ps(_mm256_loadu_ps(vx + i), dt)));
+        _mm256_storeu_ps(y + i, _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_mul_ps(velocityY, dt)));
+        _mm256_storeu_ps(vy + i, _mm256_add_ps(velocityY, fall));
+        __m256 left = _mm256_sub_ps(_mm256_loadu_ps(life + i), dt);
+        _mm256_storeu_ps(life + i, left);
+        found = AppendMaskIndices(_mm256_movemask_ps(_mm256_cmp_ps(left, zero, _CMP_LE_OQ)), i, expired, found);
+    }
+    _mm256_zeroupper();
+    int tail = StepParticlesScalar(x + i, y + i, vx + i, vy + i, life + i, count - i, gravity, dT, expired + found);
+    for (int j = found; j < found + tail; j++) {
+        expired[j] += i;
+    }
+    return found + tail;
+}
+
+__attribute__((target("avx2")))
+static int FindOffscreenAvx2(const float *x, const float *width, int count, int *indices) {
+    const __m256 zero = _mm256_setzero_ps();
+    int found = 0;
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 right = _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(width + i));
+        unsigned int mask = _mm256_movemask_ps(_mm256_cmp_ps(right, zero, _CMP_LT_OQ));
+        found = AppendMaskIndices(mask, i, indices, found);
+    }
+    for (; i < count; i++) {
+        if (x[i] + width[i] < 0) {
+            indices[found++] = i;
+        }
+    }
+    _mm256_zeroupper();
+    return found;
+}
+
+__attribute__((target("avx2")))
+static int FindOffscreenUniformAvx2(const float *x, float width, int count, int *indices) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 w = _mm256_set1_ps(width);
+    int found = 0;
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        unsigned int mask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_add_ps(_mm256_loadu_ps(x + i), w), zero, _CMP_LT_OQ));
+        found = AppendMaskIndices(mask, i, indices, found);
+    }
+    for (; i < count; i++) {
+        if (x[i] + width < 0) {
+            indices[found++] = i;
+        }
+    }
+    _mm256_zeroupper();
+    return found;
+}
+
+__attribute__((target("avx2")))
+static int CollideAabbsAvx2(AabbBox box, const float *x, const float *y, const float *boxX, const float *boxY, const float *boxWidth, const float *boxHeight, int count, uint64_t *hitMask) {
+    for (int word = 0; word < (count + 63) / 64; word++) {
+        hitMask[word] = 0;
+    }
+    const __m256 left = _mm256_set1_ps(box.x);
+    const __m256 right = _mm256_set1_ps(box.x + box.width);
+    const __m256 top = _mm256_set1_ps(box.y);
+    const __m256 bottom = _mm256_set1_ps(box.y + box.height);
+    int hits = 0;
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 otherLeft = _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(boxX + i));
+        __m256 otherTop = _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_loadu_ps(boxY + i));
+        __m256 otherRight = _mm256_add_ps(otherLeft, _mm256_loadu_ps(boxWidth + i));
+        __m256 otherBottom = _mm256_add_ps(otherTop, _mm256_loadu_ps(boxHeight + i));
+        __m256 overlap = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(left, otherRight, _CMP_LT_OQ), _mm256_cmp_ps(right, otherLeft, _CMP_GT_OQ)),
+                                       _mm256_and_ps(_mm256_cmp_ps(top, otherBottom, _CMP_LT_OQ), _mm256_cmp_ps(bottom, otherTop, _CMP_GT_OQ)));
+        unsigned int mask = _mm256_movemask_ps(overlap);
+        hitMask[i / 64] |= (uint64_t)mask << (i % 64);
+        hits += __builtin_popcount(mask);
+    }
+    for (; i < count; i++) {
+        if (AabbOverlap(box, x[i] + boxX[i], y[i] + boxY[i], boxWidth[i], boxHeight[i])) {
+            hitMask[i / 64] |= 1ULL << (i % 64);
+            hits++;
+        }
+    }
+    _mm256_zeroupper();
+    return hits;
+}
+
+__attribute__((target("avx2")))
+static void SweepIntervalsAvx2(const float *previous, const float *current, const float *size, int count, float *sweptMin, float *sweptSize) {
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 before = _mm256_loadu_ps(previous + i);
+        __m256 after = _mm256_loadu_ps(current + i);
+        _mm256_storeu_ps(sweptMin + i, _mm256_min_ps(after, before));
+        _mm256_storeu_ps(sweptSize + i, _mm256_add_ps(_mm256_loadu_ps(size + i), _mm256_andnot_ps(signBit, _mm256_sub_ps(after, before))));
+    }
+    _mm256_zeroupper();
+    SweepIntervalsScalar(previous + i, current + i, size + i, count - i, sweptMin + i, sweptSize + i);
+}
+
+#endif
+
+//one function per kernel for the selected level
+struct SimdKernelTable {
+    void (*advancePositions)(float *, const float *, int, float);
+    int (*stepAnimationTimers)(float *, const float *, int, float, int *);
+    int (*stepParticles)(float *, float *, const float *, float *, float *, int, float, float, int *);
+    int (*findOffscreen)(const float *, const float *, int, int *);
+    int (*findOffscreenUniform)(const float *, float, int, int *);
+    int (*collideAabbs)(AabbBox, const float *, const float *, const float *, const float *, const float *, const float *, int, uint64_t *);
+    void (*sweepIntervals)(const float *, const float *, const float *, int, float *, float *);
+};
+
+static const SimdKernelTable scalarKernels = {AdvancePositionsScalar, StepAnimationTimersScalar, StepParticlesScalar, FindOffscreenScalar, FindOffscreenUniformScalar, CollideAabbsScalar, SweepIntervalsScalar};
+#ifdef MOCHI_SIMD_X86
+static const SimdKernelTable sse2Kernels = {AdvancePositionsSse2, StepAnimationTimersSse2, StepParticlesSse2, FindOffscreenSse2, FindOffscreenUniformSse2, CollideAabbsSse2, SweepIntervalsSse2};
+static const SimdKernelTable avx2Kernels = {AdvancePositionsAvx2, StepAnimationTimersAvx2, StepParticlesAvx2, FindOffscreenAvx2, FindOffscreenUniformAvx2, CollideAabbsAvx2, SweepIntervalsAvx2};
+#endif
+
+static SimdLevel simdLevel;
+static const SimdKernelTable *kernels = nullptr;
+
+SimdLevel DetectSimdLevel() {
+#ifdef MOCHI_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SIMD_AVX2;
+    if (__builtin_cpu_supports("sse2")) return SIMD_SSE2;
+#endif
+    return SIMD_SCALAR;
+}
+
+void SetSimdLevel(SimdLevel level) {
+    SimdLevel supported = DetectSimdLevel();
+    simdLevel = level > supported ? supported : level;
+
+    kernels = &scalarKernels;
+#ifdef MOCHI_SIMD_X86
+    if (simdLevel == SIMD_SSE2) kernels = &sse2Kernels;
+    if (simdLevel == SIMD_AVX2) kernels = &avx2Kernels;
+#endif
+}
+
+//kernels for the current level, picked on first use
+static const SimdKernelTable &Kernels() {
+    if (!kernels) {
+        SetSimdLevel(DetectSimdLevel());
+    }
+    return *kernels;
+}
+
+SimdLevel GetSimdLevel() {
+    Kernels();
+    return simdLevel;
+}
+
+const char *SimdLevelName(SimdLevel level) {
+    switch (level) {
+        case SIMD_SSE2: return "sse2";
+        case SIMD_AVX2: return "avx2";
+        default: return "scalar";
+    }
+}
+
+void AdvancePositions(float *x, const float *speed, int count, float dT) {
+    Kernels().advancePositions(x, speed, count, dT);
+}
+
+int StepAnimationTimers(float *timer, const float *frameTime, int count, float dT, int *dueIndices) {
+    return Kernels().stepAnimationTimers(timer, frameTime, count, dT, dueIndices);
+}
+
+int StepParticles(float *x, float *y, const float *vx, float *vy, float *life, int count, float gravity, float dT, int *expired) {
+    return Kernels().stepParticles(x, y, vx, vy, life, count, gravity, dT, expired);
+}
+
+int FindOffscreen(const float *x, const float *width, int count, int *indices) {
+    return Kernels().findOffscreen(x, width, count, indices);
+}
+
+int FindOffscreenUniform(const float *x, float width, int count, int *indices) {
+    return Kernels().findOffscreenUniform(x, width, count, indices);
+}
+
+int CollideAabbs(AabbBox box, const float *x, const float *y, const float *boxX, const float *boxY, const float *boxWidth, const float *boxHeight, int count, uint64_t *hitMask) {
+    return Kernels().collideAabbs(box, x, y, boxX, boxY, boxWidth, boxHeight, count, hitMask);
+}
+
+void SweepIntervals(const float *previous, const float *current, const float *size, int count, float *sweptMin, float *sweptSize) {
+    Kernels().sweepIntervals(previous, current, size, count, sweptMin, sweptSize);
+}
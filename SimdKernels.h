@@ -0,0 +1,66 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - SIMD entity kernels
+*
+*   Bulk passes over the entity stores (movement, off-screen test, animation timers, particles) with
+*   SSE2 and AVX2 versions picked at runtime and a scalar fallback. Every version does the
+*   same float operations in the same order, so results and state hashes never depend on
+*   which one ran.
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#ifndef MOCHI_SIMD_KERNELS_H
+#define MOCHI_SIMD_KERNELS_H
+
+#include <cstdint>
+
+enum SimdLevel {
+    SIMD_SCALAR,
+    SIMD_SSE2,
+    SIMD_AVX2
+};
+
+//best level this CPU supports
+SimdLevel DetectSimdLevel();
+//level in use, starts at DetectSimdLevel()
+SimdLevel GetSimdLevel();
+//force a level (e.g. to compare against scalar), capped at what the CPU supports
+void SetSimdLevel(SimdLevel level);
+const char *SimdLevelName(SimdLevel level);
+
+//x -= speed * dT
+void AdvancePositions(float *x, const float *speed, int count, float dT);
+
+//timer += dT, timers that reached frameTime go back to 0 and their ascending indices are
+//written to dueIndices, returns how many
+int StepAnimationTimers(float *timer, const float *frameTime, int count, float dT, int *dueIndices);
+
+//particle motion: x += vx * dT, y += vy * dT, then vy += gravity * dT and life -= dT.
+//Writes the ascending indices whose life ran out (<= 0) to expired, returns how many
+int StepParticles(float *x, float *y, const float *vx, float *vy, float *life, int count, float gravity, float dT, int *expired);
+
+//write the ascending indices with x + width < 0 (fully past the left edge), returns how many
+int FindOffscreen(const float *x, const float *width, int count, int *indices);
+//same with one width for every entity
+int FindOffscreenUniform(const float *x, float width, int count, int *indices);
+
+//one axis-aligned box, tested against many
+struct AabbBox {
+    float x;
+    float y;
+    float width;
+    float height;
+};
+
+//overlap test of box against every entity box (x + boxX, y + boxY, boxWidth, boxHeight),
+//same strict test as CheckCollisionRecs. Bit i % 64 of hitMask[i / 64] is set for a hit,
+//hitMask needs (count + 63) / 64 words. Returns the number of hits
+int CollideAabbs(AabbBox box, const float *x, const float *y, const float *boxX, const float *boxY, const float *boxWidth, const float *boxHeight, int count, uint64_t *hitMask);
+
+//one axis of the boxes covering each entity's motion from previous to current:
+//sweptMin = min(previous, current), sweptSize = size + |current - previous|
+void SweepIntervals(const float *previous, const float *current, const float *size, int count, float *sweptMin, float *sweptSize);
+
+#endif
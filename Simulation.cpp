@@ -0,0 +1,806 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Simulation
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include "Simulation.h"
+#include "Profiler.h"
+#include "SimdKernels.h"
+#include "Trace.h"
+
+//broadphase group of each store
+enum { GROUP_ENEMIES, GROUP_PICKUPS };
+
+//most mask tests along one swept hit, about one per pixel of relative motion
+const int maxContactSteps = 64;
+
+//checks player on ground
+bool isOnGround(AnimationData data ,int windowHeight){
+    return data.pos.y >= windowHeight - data.rec.height;
+}
+
+//checks for collision (player | health pickup)
+bool CheckCollisionPlayerHealthPickup(AnimationData player, Rectangle healthPickup) {
+    return CheckCollisionRecs(
+        //position of both player and health pickup
+        (Rectangle){player.pos.x, player.pos.y, static_cast<float>(player.rec.width), static_cast<float>(player.rec.height)},
+        healthPickup
+    );
+}
+
+//enter | exit time of one axis, false when the boxes can never overlap on it
+static bool SweepAxis(float aMin, float aSize, float bMin, float bSize, float velocity, float &enter, float &exit) {
+    if (velocity == 0.0f) {
+        //no relative motion, overlapping the whole tick or never
+        enter = -1.0f;
+        exit = 2.0f;
+        return aMin < bMin + bSize && aMin + aSize > bMin;
+    }
+    float toFar = (bMin + bSize - aMin) / velocity;
+    float toNear = (bMin - (aMin + aSize)) / velocity;
+    enter = std::min(toFar, toNear);
+    exit = std::max(toFar, toNear);
+    return true;
+}
+
+bool SweepRecs(Rectangle a, Vector2 aMotion, Rectangle b, Vector2 bMotion, float &enter, float &exit) {
+    //move a relative to b, same strict overlap as CheckCollisionRecs
+    float enterX, exitX, enterY, exitY;
+    if (!SweepAxis(a.x, a.width, b.x, b.width, aMotion.x - bMotion.x, enterX, exitX) ||
+        !SweepAxis(a.y, a.height, b.y, b.height, aMotion.y - bMotion.y, enterY, exitY)) {
+        return false;
+    }
+    float first = std::max(enterX, enterY);
+    float last = std::min(exitX, exitY);
+    if (first >= last || first >= 1.0f || last <= 0.0f) {
+        return false;
+    }
+    enter = std::max(first, 0.0f);
+    exit = std::min(last, 1.0f);
+    return true;
+}
+
+void InitEnemyStore(EnemyStore &enemies, int capacity) {
+    enemies.count = 0;
+    enemies.capacity = capacity;
+    enemies.x.assign(capacity, 0.0f);
+    enemies.y.assign(capacity, 0.0f);
+    enemies.prevX.assign(capacity, 0.0f);
+    enemies.prevY.assign(capacity, 0.0f);
+    enemies.speed.assign(capacity, 0.0f);
+    enemies.width.assign(capacity, 0.0f);
+    enemies.hitX.assign(capacity, 0.0f);
+    enemies.hitY.assign(capacity, 0.0f);
+    enemies.hitWidth.assign(capacity, 0.0f);
+    enemies.hitHeight.assign(capacity, 0.0f);
+    InitAnimator(enemies.animation, capacity);
+    enemies.type.assign(capacity, 0);
+    enemies.broadphaseSlot.assign(capacity, -1);
+    enemies.offscreen.assign(capacity, 0);
+    enemies.sweptX.assign(capacity, 0.0f);
+    enemies.sweptY.assign(capacity, 0.0f);
+    enemies.sweptWidth.assign(capacity, 0.0f);
+    enemies.sweptHeight.assign(capacity, 0.0f);
+    enemies.hitMask.assign((capacity + 63) / 64, 0);
+}
+
+int AddEnemy(EnemyStore &enemies) {
+    if (enemies.count >= enemies.capacity) {
+        return -1;
+    }
+    enemies.broadphaseSlot[enemies.count] = -1;
+    AddAnimation(enemies.animation);
+    return enemies.count++;
+}
+
+void RemoveEnemy(EnemyStore &enemies, int index) {
+    //move the last live drone into the hole
+    int last = --enemies.count;
+    enemies.x[index] = enemies.x[last];
+    enemies.y[index] = enemies.y[last];
+    enemies.prevX[index] = enemies.prevX[last];
+    enemies.prevY[index] = enemies.prevY[last];
+    enemies.speed[index] = enemies.speed[last];
+    enemies.width[index] = enemies.width[last];
+    enemies.hitX[index] = enemies.hitX[last];
+    enemies.hitY[index] = enemies.hitY[last];
+    enemies.hitWidth[index] = enemies.hitWidth[last];
+    enemies.hitHeight[index] = enemies.hitHeight[last];
+    RemoveAnimation(enemies.animation, index);
+    enemies.type[index] = enemies.type[last];
+    enemies.broadphaseSlot[index] = enemies.broadphaseSlot[last];
+}
+
+void InitPickupStore(PickupStore &healthPickups, int capacity) {
+    healthPickups.count = 0;
+    healthPickups.capacity = capacity;
+    healthPickups.x.assign(capacity, 0.0f);
+    healthPickups.y.assign(capacity, 0.0f);
+    healthPickups.prevX.assign(capacity, 0.0f);
+    healthPickups.prevY.assign(capacity, 0.0f);
+    healthPickups.speed.assign(capacity, 0.0f);
+    healthPickups.broadphaseSlot.assign(capacity, -1);
+    healthPickups.offscreen.assign(capacity, 0);
+}
+
+int AddPickup(PickupStore &healthPickups) {
+    if (healthPickups.count >= healthPickups.capacity) {
+        return -1;
+    }
+    healthPickups.broadphaseSlot[healthPickups.count] = -1;
+    return healthPickups.count++;
+}
+
+void RemovePickup(PickupStore &healthPickups, int index) {
+    int last = --healthPickups.count;
+    healthPickups.x[index] = healthPickups.x[last];
+    healthPickups.y[index] = healthPickups.y[last];
+    healthPickups.prevX[index] = healthPickups.prevX[last];
+    healthPickups.prevY[index] = healthPickups.prevY[last];
+    healthPickups.speed[index] = healthPickups.speed[last];
+    healthPickups.broadphaseSlot[index] = healthPickups.broadphaseSlot[last];
+}
+
+void InitSimClock(SimClock &clock, int tickRate) {
+    clock.tickDt = 1.0f / tickRate;
+    clock.maxTicksPerFrame = 8;
+    ResetSimClock(clock);
+}
+
+void ResetSimClock(SimClock &clock) {
+    clock.accumulator = 0.0;
+}
+
+int AdvanceSimClock(SimClock &clock, float frameTime) {
+    clock.accumulator += frameTime;
+
+    int ticks = (int)(clock.accumulator / clock.tickDt);
+    if (ticks > clock.maxTicksPerFrame) {
+        //too far behind, drop the time we cannot catch up on
+        ticks = clock.maxTicksPerFrame;
+        clock.accumulator = ticks * (double)clock.tickDt;
+    }
+    clock.accumulator -= ticks * (double)clock.tickDt;
+    return ticks;
+}
+
+float SimClockAlpha(const SimClock &clock) {
+    return (float)(clock.accumulator / clock.tickDt);
+}
+
+Vector2 LerpPosition(Vector2 previous, Vector2 current, float alpha) {
+    return (Vector2){previous.x + (current.x - previous.x) * alpha, previous.y + (current.y - previous.y) * alpha};
+}
+
+void InitSimAssets(SimAssets &assets, int screenWidth, int screenHeight, Texture2D (*loadTexture)(const char *fileName)) {
+    assets.screenWidth = screenWidth;
+    assets.screenHeight = screenHeight;
+
+    //Mochi textures (for gameplay)
+    assets.mochiTexture = loadTexture("textures/mochi_running.png");
+    assets.mochiJumpTexture = loadTexture("textures/mochi_jump.png");
+    //health pick up texture
+    assets.healthPickupTexture = loadTexture("textures/health.png");
+    //player to enemy collision impact texture
+    assets.impactTexture = loadTexture("textures/impact.png");
+
+    //initialize drone types
+    //drone 1
+    assets.drones[0].texture = loadTexture("textures/drone1.png");
+    assets.drones[0].clip = SheetClip(assets.drones[0].texture, 4, 1.0 / 10.0, ANIMATION_LOOP);
+    //drone 2
+    assets.drones[1].texture = loadTexture("textures/drone2.png");
+    assets.drones[1].clip = SheetClip(assets.drones[1].texture, 8, 1.0 / 15.0, ANIMATION_LOOP);
+    //drone 3
+    assets.drones[2].texture = loadTexture("textures/drone3.png");
+    assets.drones[2].clip = SheetClip(assets.drones[2].texture, 4, 1.0 / 10.0, ANIMATION_LOOP);
+    //drone 4
+    assets.drones[3].texture = loadTexture("textures/drone4.png");
+    assets.drones[3].clip = SheetClip(assets.drones[3].texture, 4, 1.0 / 10.0, ANIMATION_LOOP);
+
+    //drone spawns
+    assets.groundSpawns = defaultGroundSpawns;
+    assets.airSpawns = defaultAirSpawns;
+
+    //collision masks, one per sheet
+    LoadSpriteMask(assets.mochiMask, "textures/mochi_running.png", 4);
+    LoadSpriteMask(assets.mochiJumpMask, "textures/mochi_jump.png", 4);
+    LoadSpriteMask(assets.drones[0].mask, "textures/drone1.png", assets.drones[0].clip.frameCount);
+    LoadSpriteMask(assets.drones[1].mask, "textures/drone2.png", assets.drones[1].clip.frameCount);
+    LoadSpriteMask(assets.drones[2].mask, "textures/drone3.png", assets.drones[2].clip.frameCount);
+    LoadSpriteMask(assets.drones[3].mask, "textures/drone4.png", assets.drones[3].clip.frameCount);
+
+    //collision box for drones, the whole frame (the masks decide the actual hit)
+    for (int i = 0; i < droneTypeCount; i++) {
+        assets.droneCollisionRectangles[i] = (Rectangle){0};
+        assets.droneCollisionRectangles[i].width = assets.drones[i].texture.width / assets.drones[i].clip.frameCount;
+        assets.droneCollisionRectangles[i].height = assets.drones[i].texture.height;
+    }
+}
+
+void InitGameSim(GameSim &sim, const SimAssets &assets, uint64_t seed, int enemyCapacity, int pickupCapacity, int particleCapacity) {
+    sim = GameSim{};
+    RngSeed(sim.rng, seed);
+    //separate stream, effects never draw from the gameplay one
+    RngSeed(sim.effectRng, seed ^ 0x9e3779b97f4a7c15ULL);
+
+    //entity storage, allocated once
+    InitEnemyStore(sim.enemies, enemyCapacity);
+    InitPickupStore(sim.healthPickups, pickupCapacity);
+
+    //Mochi properties
+    //texture
+    sim.mochiData.rec.width = assets.mochiTexture.width/4;
+    sim.mochiData.rec.height = assets.mochiTexture.height;
+    sim.mochiData.rec.x = 0;
+    sim.mochiData.rec.y = 0;
+    //animation
+    InitAnimator(sim.mochiAnimation, 1);
+    AddAnimation(sim.mochiAnimation);
+
+    //health system
+    sim.playerHealth.maxHealth = 3;
+
+    //first spawn of every kind, later ones are queued as each one happens
+    InitSpawnScheduler(sim.spawns);
+    ScheduleSpawn(sim.spawns, SPAWN_GROUND_DRONE, DrawSpawnInterval(assets.groundSpawns, sim.rng));
+    ScheduleSpawn(sim.spawns, SPAWN_AIR_DRONE, DrawSpawnInterval(assets.airSpawns, sim.rng));
+    ScheduleSpawn(sim.spawns, SPAWN_HEALTH, firstHealthSpawnTime);
+    //alternate ground | air spawns
+    sim.spawnOnGround = true;
+
+    //player to enemy collision impact properties
+    InitImpactEffects(sim.impacts, maxImpactEffects, SheetClip(assets.impactTexture, 8, 1.0 / 16.0, ANIMATION_ONCE));
+    InitParticleStore(sim.particles, particleCapacity);
+
+    ResetGameSim(sim, assets);
+}
+
+void InitStressSim(GameSim &sim, const SimAssets &assets, uint64_t seed, int count, int particleCapacity) {
+    InitGameSim(sim, assets, seed, count, count, particleCapacity);
+    //refill both stores back up to capacity every tick
+    sim.stressSpawnsPerTick = count;
+    sim.crashedEnemies.assign(count, 0);
+    sim.wreckedPickups.assign(count, 0);
+}
+
+void ResetGameSim(GameSim &sim, const SimAssets &assets) {
+    //reset the player position
+    sim.mochiData.pos.x = 150 - sim.mochiData.rec.width / 2;
+    sim.mochiData.pos.y = assets.screenHeight - sim.mochiData.rec.height;
+    sim.mochiPrevPos = sim.mochiData.pos;
+    PlayAnimation(sim.mochiAnimation, 0, SheetClip(assets.mochiTexture, 4, 1.0 / 16.0, ANIMATION_LOOP));
+    sim.velocity = 0;
+    sim.isInAir = false;
+
+    sim.gameTime = 0.0;
+    sim.playerScore = 0;
+    sim.gracePeriodRemaining = 0.0;
+    sim.playerHealth.currentHealth = sim.playerHealth.maxHealth;
+
+    //clear out enemy and health pickup data
+    sim.enemies.count = 0;
+    sim.enemies.animation.count = 0;
+    sim.healthPickups.count = 0;
+    ResetSweepAndPrune(sim.broadphase);
+    //clear out effects
+    ClearImpactEffects(sim.impacts);
+    sim.particles.count = 0;
+
+    sim.gameOver = false;
+    sim.events = 0;
+}
+
+bool SpawnHealthPickup(PickupStore &healthPickups, const SimAssets &assets, bool onGround) {
+    const Texture2D &healthPickupTexture = assets.healthPickupTexture;
+
+    int i = AddPickup(healthPickups);
+    if (i < 0) {
+        return false;
+    }
+    //initialize a new health pickup
+    healthPickups.speed[i] = 200;
+    healthPickups.x[i] = static_cast<float>(assets.screenWidth);
+    if (onGround) {
+        //spawn on the ground
+        healthPickups.y[i] = static_cast<float>(assets.screenHeight - (healthPickupTexture.height + 10));
+    } else {
+        //spawn in the air
+        healthPickups.y[i] = static_cast<float>(assets.screenHeight - (healthPickupTexture.height + 120));
+    }
+    healthPickups.prevX[i] = healthPickups.x[i];
+    healthPickups.prevY[i] = healthPickups.y[i];
+    return true;
+}
+
+void UpdateHealthPickups(PickupStore &healthPickups, const SimAssets &assets, float dT) {
+    //update the position of live health pickups
+    AdvancePositions(healthPickups.x.data(), healthPickups.speed.data(), healthPickups.count, dT);
+
+    //drop the ones that scrolled off the left edge, back to front so swaps stay valid
+    int found = FindOffscreenUniform(healthPickups.x.data(), static_cast<float>(assets.healthPickupTexture.width), healthPickups.count, healthPickups.offscreen.data());
+    for (int i = found - 1; i >= 0; i--) {
+        RemovePickup(healthPickups, healthPickups.offscreen[i]);
+    }
+}
+
+//type dependent fields of a freshly added drone
+static void SetEnemyType(EnemyStore &enemies, int i, const SimAssets &assets, int droneType) {
+    const Drone &drone = assets.drones[droneType];
+    const Rectangle &hitbox = assets.droneCollisionRectangles[droneType];
+    enemies.type[i] = droneType;
+    enemies.width[i] = static_cast<float>(drone.texture.width);
+    enemies.hitX[i] = hitbox.x;
+    enemies.hitY[i] = hitbox.y;
+    enemies.hitWidth[i] = hitbox.width;
+    enemies.hitHeight[i] = hitbox.height;
+    PlayAnimation(enemies.animation, i, drone.clip);
+}
+
+bool SpawnEnemy(EnemyStore &enemies, const SimAssets &assets, const SpawnTable &table, Rng &rng) {
+    int i = AddEnemy(enemies);
+    if (i < 0) {
+        return false;
+    }
+    //drone type, then one of its heights and its speed
+    const SpawnEntry &entry = PickSpawnEntry(table, rng);
+    const Drone &drone = assets.drones[entry.droneType];
+    SetEnemyType(enemies, i, assets, entry.droneType);
+    const SpawnHeight &height = entry.heights[RngRange(rng, 0, entry.heightCount - 1)];
+
+    enemies.x[i] = static_cast<float>(assets.screenWidth);
+    enemies.y[i] = assets.screenHeight - height.aboveGround - drone.texture.height * height.anchor;
+    enemies.prevX[i] = enemies.x[i];
+    enemies.prevY[i] = enemies.y[i];
+    enemies.speed[i] = RngRange(rng, entry.minSpeed, entry.maxSpeed);
+    return true;
+}
+
+void UpdateEnemies(EnemyStore &enemies, float dT) {
+    const int count = enemies.count;
+
+    //movement and animation frames over the live range
+    AdvancePositions(enemies.x.data(), enemies.speed.data(), count, dT);
+    AdvanceAnimations(enemies.animation, dT);
+
+    //despawn drones that are out of the screen, back to front so swaps stay valid
+    int found = FindOffscreen(enemies.x.data(), enemies.width.data(), count, enemies.offscreen.data());
+    for (int i = found - 1; i >= 0; i--) {
+        RemoveEnemy(enemies, enemies.offscreen[i]);
+    }
+}
+
+bool PlayerTouchesEnemy(const GameSim &sim, const EnemyStore &enemies, int i, const SimAssets &assets, float t) {
+    const AnimationData &mochiData = sim.mochiData;
+    //same sheet | frame as drawn
+    const SpriteMask &mochiMask = sim.isInAir ? assets.mochiJumpMask : assets.mochiMask;
+    int mochiFrame = sim.mochiAnimation.frame[0];
+
+    Vector2 mochiPos = LerpPosition(sim.mochiPrevPos, mochiData.pos, t);
+    Vector2 enemyPos = LerpPosition((Vector2){enemies.prevX[i], enemies.prevY[i]}, (Vector2){enemies.x[i], enemies.y[i]}, t);
+    return SpriteMasksOverlap(mochiMask, mochiFrame, (int)floorf(mochiPos.x), (int)floorf(mochiPos.y),
+                              assets.drones[enemies.type[i]].mask, enemies.animation.frame[i], (int)floorf(enemyPos.x), (int)floorf(enemyPos.y));
+}
+
+//earliest point in [enter, exit] where Mochi's and drone i's pixels touch,
+//stepping about one pixel of relative motion at a time
+static bool FindPixelContact(const GameSim &sim, const EnemyStore &enemies, int i, const SimAssets &assets, float enter, float exit, float &contact) {
+    float relativeX = (sim.mochiData.pos.x - sim.mochiPrevPos.x) - (enemies.x[i] - enemies.prevX[i]);
+    float relativeY = (sim.mochiData.pos.y - sim.mochiPrevPos.y) - (enemies.y[i] - enemies.prevY[i]);
+    float distance = std::max(fabsf(relativeX), fabsf(relativeY)) * (exit - enter);
+    int steps = std::min((int)ceilf(distance), maxContactSteps);
+
+    for (int step = 0; step <= steps; step++) {
+        float t = steps > 0 ? enter + (exit - enter) * step / steps : exit;
+        if (PlayerTouchesEnemy(sim, enemies, i, assets, t)) {
+            contact = t;
+            return true;
+        }
+    }
+    return false;
+}
+
+void CollidePlayerWithEnemies(GameSim &sim, EnemyStore &enemies, const SimAssets &assets) {
+    AnimationData &mochiData = sim.mochiData;
+    const int count = enemies.count;
+
+    //boxes covering every drone's motion this tick
+    SweepIntervals(enemies.prevX.data(), enemies.x.data(), enemies.hitWidth.data(), count, enemies.sweptX.data(), enemies.sweptWidth.data());
+    SweepIntervals(enemies.prevY.data(), enemies.y.data(), enemies.hitHeight.data(), count, enemies.sweptY.data(), enemies.sweptHeight.data());
+
+    //every swept drone against Mochi's swept box at once, hits come back as bits
+    const Vector2 mochiMotion = {mochiData.pos.x - sim.mochiPrevPos.x, mochiData.pos.y - sim.mochiPrevPos.y};
+    const Rectangle mochiStart = {sim.mochiPrevPos.x, sim.mochiPrevPos.y, mochiData.rec.width, mochiData.rec.height};
+    AabbBox mochiBox = {std::min(mochiStart.x, mochiData.pos.x), std::min(mochiStart.y, mochiData.pos.y),
+                        mochiStart.width + fabsf(mochiMotion.x), mochiStart.height + fabsf(mochiMotion.y)};
+    int hits = CollideAabbs(mochiBox, enemies.sweptX.data(), enemies.sweptY.data(), enemies.hitX.data(), enemies.hitY.data(),
+                            enemies.sweptWidth.data(), enemies.sweptHeight.data(), count, enemies.hitMask.data());
+    if (hits == 0) {
+        return;
+    }
+
+    //handle hits back to front so removing one never moves another unhandled hit
+    for (int word = (count + 63) / 64 - 1; word >= 0; word--) {
+        uint64_t bits = enemies.hitMask[word];
+        while (bits) {
+            int bit = 63 - __builtin_clzll(bits);
+            bits &= ~(1ULL << bit);
+            int i = word * 64 + bit;
+
+            //the swept boxes overlap, did the boxes meet during the tick?
+            Rectangle enemyStart = {enemies.prevX[i] + enemies.hitX[i], enemies.prevY[i] + enemies.hitY[i], enemies.hitWidth[i], enemies.hitHeight[i]};
+            Vector2 enemyMotion = {enemies.x[i] - enemies.prevX[i], enemies.y[i] - enemies.prevY[i]};
+            float enter, exit;
+            if (!SweepRecs(mochiStart, mochiMotion, enemyStart, enemyMotion, enter, exit)) {
+                continue;
+            }
+            //only solid pixels count
+            float contact;
+            if (!FindPixelContact(sim, enemies, i, assets, enter, exit, contact)) {
+                continue;
+            }
+
+            //out of lives
+            if (sim.playerHealth.currentHealth <= 0) {
+                sim.gameOver = true;
+                sim.events |= SIM_EVENT_GAMEOVER;
+            } else {
+                //decrease player health
+                sim.events |= SIM_EVENT_IMPACT;
+                sim.playerHealth.currentHealth--;
+
+                //set the grace period remaining time to 1.5 sec
+                sim.gracePeriodRemaining = gracePeriodDuration;
+
+                //impact explosion at the collision point, sparks from its middle
+                Vector2 impactPos = {enemies.prevX[i] + enemyMotion.x * contact, sim.mochiPrevPos.y + mochiMotion.y * contact};
+                SpawnImpactEffect(sim.impacts, impactPos);
+                const AnimationClip &impactClip = sim.impacts.clip;
+                EmitParticles(sim.particles, PARTICLE_SPARK, (Vector2){impactPos.x + impactClip.frameWidth / 2, impactPos.y + impactClip.frameHeight / 2}, sim.effectRng);
+
+                //remove the collided drone
+                RemoveEnemy(enemies, i);
+            }
+        }
+    }
+}
+
+void CollectHealthPickups(GameSim &sim, PickupStore &healthPickups, const SimAssets &assets) {
+    const AnimationData &mochiData = sim.mochiData;
+    const Rectangle mochiStart = {sim.mochiPrevPos.x, sim.mochiPrevPos.y, mochiData.rec.width, mochiData.rec.height};
+    const Vector2 mochiMotion = {mochiData.pos.x - sim.mochiPrevPos.x, mochiData.pos.y - sim.mochiPrevPos.y};
+    const float pickupWidth = static_cast<float>(assets.healthPickupTexture.width);
+    const float pickupHeight = static_cast<float>(assets.healthPickupTexture.height);
+
+    //check for collisions with health pickups over the tick and collect them
+    for (int i = healthPickups.count - 1; i >= 0; i--) {
+        Rectangle pickupStart = {healthPickups.prevX[i], healthPickups.prevY[i], pickupWidth, pickupHeight};
+        Vector2 pickupMotion = {healthPickups.x[i] - healthPickups.prevX[i], healthPickups.y[i] - healthPickups.prevY[i]};
+        float enter, exit;
+        if (SweepRecs(mochiStart, mochiMotion, pickupStart, pickupMotion, enter, exit)) {
+            if (sim.playerHealth.currentHealth < sim.playerHealth.maxHealth) {
+                //increase player's health by 1
+                sim.playerHealth.currentHealth++;
+
+                //eat sound effect
+                sim.events |= SIM_EVENT_EAT;
+            }
+            //remove the eaten health pickup
+            RemovePickup(healthPickups, i);
+        }
+    }
+}
+
+//stress mode: top both stores up with entities spread over a lane right of the screen
+static void SpawnStressEntities(GameSim &sim, const SimAssets &assets) {
+    EnemyStore &enemies = sim.enemies;
+    PickupStore &healthPickups = sim.healthPickups;
+    const int enemyLane = (int)(enemies.capacity * stressSpacing);
+    const int pickupLane = (int)(healthPickups.capacity * stressSpacing);
+
+    for (int spawn = 0; spawn < sim.stressSpawnsPerTick; spawn++) {
+        int i = AddEnemy(enemies);
+        if (i < 0) {
+            break;
+        }
+        int droneType = RngRange(sim.rng, 0, droneTypeCount - 1);
+        SetEnemyType(enemies, i, assets, droneType);
+        enemies.x[i] = static_cast<float>(assets.screenWidth + RngRange(sim.rng, 0, enemyLane));
+        enemies.y[i] = static_cast<float>(RngRange(sim.rng, 0, assets.screenHeight - assets.drones[droneType].texture.height));
+        enemies.prevX[i] = enemies.x[i];
+        enemies.prevY[i] = enemies.y[i];
+        enemies.speed[i] = RngRange(sim.rng, 200, 800);
+    }
+
+    for (int spawn = 0; spawn < sim.stressSpawnsPerTick; spawn++) {
+        int i = AddPickup(healthPickups);
+        if (i < 0) {
+            break;
+        }
+        healthPickups.x[i] = static_cast<float>(assets.screenWidth + RngRange(sim.rng, 0, pickupLane));
+        healthPickups.y[i] = static_cast<float>(RngRange(sim.rng, 0, assets.screenHeight - assets.healthPickupTexture.height));
+        healthPickups.prevX[i] = healthPickups.x[i];
+        healthPickups.prevY[i] = healthPickups.y[i];
+        healthPickups.speed[i] = 200;
+    }
+}
+
+void CollideEntities(GameSim &sim, const SimAssets &assets) {
+    EnemyStore &enemies = sim.enemies;
+    PickupStore &healthPickups = sim.healthPickups;
+
+    BroadphaseGroup groups[2] = {};
+    groups[GROUP_ENEMIES].count = enemies.count;
+    groups[GROUP_ENEMIES].x = enemies.x.data();
+    groups[GROUP_ENEMIES].y = enemies.y.data();
+    groups[GROUP_ENEMIES].boxX = enemies.hitX.data();
+    groups[GROUP_ENEMIES].boxY = enemies.hitY.data();
+    groups[GROUP_ENEMIES].width = enemies.hitWidth.data();
+    groups[GROUP_ENEMIES].height = enemies.hitHeight.data();
+    groups[GROUP_ENEMIES].slot = enemies.broadphaseSlot.data();
+    groups[GROUP_PICKUPS].count = healthPickups.count;
+    groups[GROUP_PICKUPS].x = healthPickups.x.data();
+    groups[GROUP_PICKUPS].y = healthPickups.y.data();
+    groups[GROUP_PICKUPS].uniformWidth = static_cast<float>(assets.healthPickupTexture.width);
+    groups[GROUP_PICKUPS].uniformHeight = static_cast<float>(assets.healthPickupTexture.height);
+    groups[GROUP_PICKUPS].slot = healthPickups.broadphaseSlot.data();
+    UpdateSweepAndPrune(sim.broadphase, groups, 2);
+
+    //mark first, a drone can be in several pairs
+    std::vector<char> &crashedEnemies = sim.crashedEnemies;
+    std::vector<char> &wreckedPickups = sim.wreckedPickups;
+    std::fill_n(crashedEnemies.begin(), enemies.count, 0);
+    std::fill_n(wreckedPickups.begin(), healthPickups.count, 0);
+    for (const BroadphasePair &pair : sim.broadphase.pairs) {
+        if (pair.groupA == GROUP_ENEMIES && pair.groupB == GROUP_ENEMIES) {
+            crashedEnemies[pair.indexA] = 1;
+            crashedEnemies[pair.indexB] = 1;
+        } else if (pair.groupA == GROUP_PICKUPS && pair.groupB == GROUP_ENEMIES) {
+            wreckedPickups[pair.indexA] = 1;
+        } else if (pair.groupA == GROUP_ENEMIES && pair.groupB == GROUP_PICKUPS) {
+            wreckedPickups[pair.indexB] = 1;
+        }
+    }
+
+    //back to front so swaps stay valid
+    for (int i = enemies.count - 1; i >= 0; i--) {
+        if (crashedEnemies[i]) {
+            //sparks from the middle of the wreck
+            Vector2 center = {enemies.x[i] + enemies.hitX[i] + enemies.hitWidth[i] / 2, enemies.y[i] + enemies.hitY[i] + enemies.hitHeight[i] / 2};
+            EmitParticles(sim.particles, PARTICLE_SPARK, center, sim.effectRng);
+            RemoveEnemy(enemies, i);
+        }
+    }
+    for (int i = healthPickups.count - 1; i >= 0; i--) {
+        if (wreckedPickups[i]) {
+            RemovePickup(healthPickups, i);
+        }
+    }
+}
+
+//create what one due event stands for and queue the next of its kind,
+//false when the store is full and the event has to wait
+static bool RunSpawnEvent(GameSim &sim, const SimAssets &assets, SpawnKind kind) {
+    switch (kind) {
+        case SPAWN_GROUND_DRONE:
+        case SPAWN_AIR_DRONE: {
+            const SpawnTable &table = kind == SPAWN_GROUND_DRONE ? assets.groundSpawns : assets.airSpawns;
+            if (!SpawnEnemy(sim.enemies, assets, table, sim.rng)) {
+                return false;
+            }
+            TraceInstant(kind == SPAWN_GROUND_DRONE ? "ground drone spawn" : "air drone spawn", "sim");
+            ScheduleSpawn(sim.spawns, kind, sim.spawns.now + DrawSpawnInterval(table, sim.rng));
+            return true;
+        }
+        default:
+            //a full store skips this health pickup, it does not wait
+            if (SpawnHealthPickup(sim.healthPickups, assets, sim.spawnOnGround)) {
+                TraceInstant("health spawn", "sim");
+            }
+            //alternate between ground and air spawns
+            sim.spawnOnGround = !sim.spawnOnGround;
+            ScheduleSpawn(sim.spawns, kind, sim.spawns.now + RngFloat(sim.rng, minHealthSpawnTime, maxHealthSpawnTime));
+            return true;
+    }
+}
+
+//everything the scheduler has due this tick
+static void RunDueSpawns(GameSim &sim, const SimAssets &assets, float dT) {
+    SpawnScheduler &spawns = sim.spawns;
+    AdvanceSpawnScheduler(spawns, dT);
+
+    //events that found their store full go back in the queue for the next tick
+    SpawnKind waiting[maxSpawnEvents];
+    int waitingCount = 0;
+    SpawnKind kind;
+    while (PopDueSpawn(spawns, kind)) {
+        if (!RunSpawnEvent(sim, assets, kind)) {
+            waiting[waitingCount++] = kind;
+        }
+    }
+    for (int i = 0; i < waitingCount; i++) {
+        ScheduleSpawn(spawns, waiting[i], spawns.now);
+    }
+}
+
+//remember where every entity was before this tick moves it
+static void SaveEntityPositions(GameSim &sim) {
+    sim.mochiPrevPos = sim.mochiData.pos;
+    EnemyStore &enemies = sim.enemies;
+    std::copy(enemies.x.begin(), enemies.x.begin() + enemies.count, enemies.prevX.begin());
+    std::copy(enemies.y.begin(), enemies.y.begin() + enemies.count, enemies.prevY.begin());
+    PickupStore &healthPickups = sim.healthPickups;
+    std::copy(healthPickups.x.begin(), healthPickups.x.begin() + healthPickups.count, healthPickups.prevX.begin());
+    std::copy(healthPickups.y.begin(), healthPickups.y.begin() + healthPickups.count, healthPickups.prevY.begin());
+    SaveParticlePositions(sim.particles);
+}
+
+void StepGameSim(GameSim &sim, const SimAssets &assets, SimInput input, float dT) {
+    AnimationData &mochiData = sim.mochiData;
+    const int screenHeight = assets.screenHeight;
+
+    sim.events = 0;
+    SaveEntityPositions(sim);
+
+    //game time | score
+    sim.gameTime += dT;
+    sim.playerScore = (int)(sim.gameTime * 1000);
+
+    ProfilerBegin(PROFILE_MOCHI_UPDATE);
+    //Update mochi position
+    mochiData.pos.y += sim.velocity * dT;
+
+    //update Mochi animation frame (not in air)
+    if (!sim.isInAir) {
+        AdvanceAnimations(sim.mochiAnimation, dT);
+    }
+
+    //Mochi ground check
+    if (isOnGround(mochiData, screenHeight)) {
+        //Mochi on ground, a puff of dust under her feet when she just landed
+        if (sim.isInAir) {
+            EmitParticles(sim.particles, PARTICLE_DUST, (Vector2){mochiData.pos.x + mochiData.rec.width / 2, screenHeight - 2.0f}, sim.effectRng);
+        }
+        sim.velocity = 0;
+        sim.isInAir = false;
+
+        //set the Y position to the exact position of the ground after landing
+        mochiData.pos.y = screenHeight - mochiData.rec.height;
+    } else {
+        //Mochi in air
+        sim.velocity += gravity * dT;
+        sim.isInAir = true;
+    }
+
+    //jump check
+    if (input.jump && !sim.isInAir) {
+        sim.velocity += jumpVelocity;
+        //use jump texture when jumping
+        mochiData.rec.width = assets.mochiJumpTexture.width / 4;
+        //reset y pos
+        mochiData.pos.y = screenHeight - mochiData.rec.height;
+
+        sim.events |= SIM_EVENT_JUMP;
+    } else {
+        //use running texture when not jumping
+        mochiData.rec.width = assets.mochiTexture.width / 4;
+    }
+    ProfilerEnd(PROFILE_MOCHI_UPDATE);
+
+    //drone | health spawns that are due, usually none
+    ProfilerBegin(PROFILE_SPAWNS);
+    RunDueSpawns(sim, assets, dT);
+    if (sim.stressSpawnsPerTick > 0) {
+        SpawnStressEntities(sim, assets);
+    }
+    ProfilerEnd(PROFILE_SPAWNS);
+
+    ProfilerBegin(PROFILE_PICKUPS);
+    UpdateHealthPickups(sim.healthPickups, assets, dT);
+    CollectHealthPickups(sim, sim.healthPickups, assets);
+    ProfilerEnd(PROFILE_PICKUPS);
+
+    ProfilerBegin(PROFILE_ENEMY_UPDATE);
+    UpdateEnemies(sim.enemies, dT);
+
+    //checks for collisions player and enemy collsions during grace period,
+    //after the move so the whole tick's motion is tested
+    if (sim.gracePeriodRemaining > 0.0) {
+        sim.gracePeriodRemaining -= dT;
+    } else {
+        CollidePlayerWithEnemies(sim, sim.enemies, assets);
+    }
+    ProfilerEnd(PROFILE_ENEMY_UPDATE);
+
+    if (sim.stressSpawnsPerTick > 0) {
+        ProfilerBegin(PROFILE_BROADPHASE);
+        CollideEntities(sim, assets);
+        ProfilerEnd(PROFILE_BROADPHASE);
+    }
+
+    //explosion frames | particles, after every hit of this tick was added
+    ProfilerBegin(PROFILE_EFFECTS);
+    UpdateImpactEffects(sim.impacts, dT);
+    UpdateParticles(sim.particles, dT);
+    ProfilerEnd(PROFILE_EFFECTS);
+
+    //reset the player's velocity after death
+    if (sim.gameOver) {
+        sim.velocity = 0;
+        sim.isInAir = false;
+    }
+}
+
+//FNV-1a over explicit fields (never raw struct bytes, padding and texture ids differ)
+static void HashBytes(uint64_t &hash, const void *data, size_t size) {
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+}
+
+template <typename T>
+static void HashValue(uint64_t &hash, T value) {
+    HashBytes(hash, &value, sizeof(value));
+}
+
+uint64_t HashGameSim(const GameSim &sim) {
+    uint64_t hash = 14695981039346656037ULL;
+
+    //Mochi
+    HashValue(hash, sim.mochiData.pos.x);
+    HashValue(hash, sim.mochiData.pos.y);
+    HashValue(hash, sim.mochiData.rec.width);
+    HashValue(hash, sim.mochiAnimation.frame[0]);
+    HashValue(hash, sim.mochiAnimation.timer[0]);
+    HashValue(hash, sim.velocity);
+    HashValue(hash, sim.isInAir);
+    HashValue(hash, sim.playerHealth.currentHealth);
+
+    //live entities in store order
+    const EnemyStore &enemies = sim.enemies;
+    HashValue(hash, enemies.count);
+    for (int i = 0; i < enemies.count; i++) {
+        HashValue(hash, enemies.x[i]);
+        HashValue(hash, enemies.y[i]);
+        HashValue(hash, enemies.speed[i]);
+        HashValue(hash, enemies.type[i]);
+        HashValue(hash, enemies.animation.frame[i]);
+        HashValue(hash, enemies.animation.timer[i]);
+    }
+    const PickupStore &healthPickups = sim.healthPickups;
+    HashValue(hash, healthPickups.count);
+    for (int i = 0; i < healthPickups.count; i++) {
+        HashValue(hash, healthPickups.x[i]);
+        HashValue(hash, healthPickups.y[i]);
+    }
+    //explosions, particles are left out (cosmetic, their count depends on --particles)
+    const ImpactEffects &impacts = sim.impacts;
+    HashValue(hash, impacts.count);
+    for (int i = 0; i < impacts.count; i++) {
+        HashValue(hash, impacts.x[i]);
+        HashValue(hash, impacts.animation.frame[i]);
+    }
+
+    //timers
+    HashValue(hash, sim.gameTime);
+    HashValue(hash, sim.gracePeriodRemaining);
+    HashValue(hash, sim.spawns.now);
+    HashValue(hash, sim.spawns.count);
+    for (int i = 0; i < sim.spawns.count; i++) {
+        HashValue(hash, sim.spawns.events[i].time);
+        HashValue(hash, (int)sim.spawns.events[i].kind);
+    }
+    HashValue(hash, sim.spawnOnGround);
+    HashValue(hash, sim.rng.state);
+    HashValue(hash, sim.gameOver);
+
+    return hash;
+}
@@ -0,0 +1,273 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Simulation
+*
+*   Gameplay update logic (physics, spawning, collision, grace period, effects)
+*   with no window, audio device or GPU dependency. Driven by an explicit dt and input.
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#ifndef MOCHI_SIMULATION_H
+#define MOCHI_SIMULATION_H
+
+#include <cstdint>
+#include <vector>
+#include "raylib.h"
+#include "Animator.h"
+#include "Broadphase.h"
+#include "CollisionMask.h"
+#include "Effects.h"
+#include "Random.h"
+#include "Spawner.h"
+
+//default store capacity, max on screen before spawns fail
+const int maxEnemies = 10;
+const int maxHealthPickups = 10;
+//drone 1-3 (ground) and drone 4 (air)
+const int droneTypeCount = 4;
+
+//Mochi main animation data, rec is one frame's size (frames come from GameSim::mochiAnimation)
+struct AnimationData {
+    Rectangle rec;
+    Vector2 pos;
+};
+
+//Enemy drones, one array per property. Live drones are packed into [0, count),
+//despawning swaps the last one into the hole so passes never skip dead slots
+struct EnemyStore {
+    int count;
+    int capacity;
+    std::vector<float> x;
+    std::vector<float> y;
+    //position before the current tick, for drawing between ticks
+    std::vector<float> prevX;
+    std::vector<float> prevY;
+    std::vector<float> speed;
+    //sprite sheet width, the drone despawns once x + width < 0
+    std::vector<float> width;
+    //hitbox offset | size of the drone's type, from SimAssets::droneCollisionRectangles
+    std::vector<float> hitX;
+    std::vector<float> hitY;
+    std::vector<float> hitWidth;
+    std::vector<float> hitHeight;
+    //animation, drone i plays animation i
+    Animator animation;
+    //index into SimAssets::drones
+    std::vector<int> type;
+    //position in the stress mode broadphase order, -1 for new drones
+    std::vector<int> broadphaseSlot;
+    //indices found by the off-screen kernel, scratch
+    std::vector<int> offscreen;
+    //collision scratch: boxes covering each drone's whole motion this tick | hit bits
+    //from the collision kernel, (capacity + 63) / 64 words
+    std::vector<float> sweptX;
+    std::vector<float> sweptY;
+    std::vector<float> sweptWidth;
+    std::vector<float> sweptHeight;
+    std::vector<uint64_t> hitMask;
+};
+
+//Enemy drone main animation data
+struct Drone {
+    Texture2D texture;
+    AnimationClip clip;
+    //solid pixels of each frame, pixel-exact hits
+    SpriteMask mask;
+};
+
+//Health pick ups, packed like EnemyStore (size comes from SimAssets::healthPickupTexture)
+struct PickupStore {
+    int count;
+    int capacity;
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> prevX;
+    std::vector<float> prevY;
+    std::vector<float> speed;
+    std::vector<int> broadphaseSlot;
+    //indices found by the off-screen kernel, scratch
+    std::vector<int> offscreen;
+};
+
+//Health system properties
+struct HealthSystem {
+    Texture2D heartTexture;
+    int maxHealth;
+    int currentHealth;
+};
+
+//things that happened during a step, the caller plays the matching sounds
+enum SimEvent {
+    SIM_EVENT_JUMP = 1 << 0,
+    SIM_EVENT_EAT = 1 << 1,
+    SIM_EVENT_IMPACT = 1 << 2,
+    SIM_EVENT_GAMEOVER = 1 << 3
+};
+
+//player input for one step
+struct SimInput {
+    bool jump;
+};
+
+//textures the simulation reads, only width | height are used so headless
+//runs can fill them from CPU-side images (id stays 0)
+struct SimAssets {
+    int screenWidth;
+    int screenHeight;
+    Texture2D mochiTexture;
+    Texture2D mochiJumpTexture;
+    Texture2D healthPickupTexture;
+    Texture2D impactTexture;
+    Drone drones[droneTypeCount];
+    //what ground | air drone spawns create and how often
+    SpawnTable groundSpawns;
+    SpawnTable airSpawns;
+    //collision box for each drone type, x | y offset from the drone's position.
+    //Only the broad phase, a box hit then has to pass the pixel masks
+    Rectangle droneCollisionRectangles[droneTypeCount];
+    //Mochi's solid pixels, running | jumping frames
+    SpriteMask mochiMask;
+    SpriteMask mochiJumpMask;
+};
+
+//gameplay state of one run
+struct GameSim {
+    //Mochi (player)
+    AnimationData mochiData;
+    //position before the current tick, collisions sweep from here to mochiData.pos
+    Vector2 mochiPrevPos;
+    //running frames, paused in the air
+    Animator mochiAnimation;
+    int velocity;
+    bool isInAir;
+    HealthSystem playerHealth;
+
+    //entities
+    PickupStore healthPickups;
+    EnemyStore enemies;
+
+    //effects (impact explosions | particles), drawn only. Particles have their own random
+    //numbers so the particle capacity never changes gameplay
+    ImpactEffects impacts;
+    ParticleStore particles;
+    Rng effectRng;
+
+    //score | timers
+    double gameTime;
+    int playerScore;
+    double gracePeriodRemaining;
+    //upcoming ground | air drone and health spawns, keeps running across runs
+    SpawnScheduler spawns;
+    //alternate ground | air health spawns
+    bool spawnOnGround;
+
+    //game-owned random numbers for every spawn decision
+    Rng rng;
+
+    //stress mode (--stress): stores refilled by up to this many entities a tick, 0 when off
+    int stressSpawnsPerTick;
+    //drone | drone and drone | pickup pairs, only used in stress mode
+    SweepAndPrune broadphase;
+    //stress mode drones | pickups marked for removal by broadphase pairs, scratch
+    std::vector<char> crashedEnemies;
+    std::vector<char> wreckedPickups;
+
+    //set once health runs out and Mochi is hit again
+    bool gameOver;
+    //SimEvent bits raised by the last step
+    unsigned int events;
+};
+
+//fixed rate simulation clock, runs zero or more ticks per rendered frame
+struct SimClock {
+    //seconds per tick
+    float tickDt;
+    //frame time not yet simulated
+    double accumulator;
+    //cap so a long hitch cannot queue up an endless catch-up
+    int maxTicksPerFrame;
+};
+
+//gravity (pixel/frame/frame)/s
+const int gravity{1'600};
+//Mochi jump velocity
+const int jumpVelocity{-580};
+//time before user | drone collision counts again (sec)
+const double gracePeriodDuration = 1.5;
+
+//health pickup spawn time (sec), drone spawn times are in the spawn tables
+const float firstHealthSpawnTime = 15.0f;
+const float minHealthSpawnTime = 15.0f;
+const float maxHealthSpawnTime = 30.0f;
+
+//load every texture the simulation needs through loadTexture
+//(LoadTexture when windowed, a size-only loader when headless), collision masks
+//are always decoded on the CPU
+void InitSimAssets(SimAssets &assets, int screenWidth, int screenHeight, Texture2D (*loadTexture)(const char *fileName));
+
+//stress mode lane length per entity (px), the lane starts at the right screen edge.
+//Sparse enough that refills rarely land on each other: the stores stay about 98% full
+//after each tick's crashes, tighter lanes crash most of what was just spawned
+const float stressSpacing = 128.0f;
+
+//initialize all simulation state, called once at startup
+void InitGameSim(GameSim &sim, const SimAssets &assets, uint64_t seed, int enemyCapacity = maxEnemies, int pickupCapacity = maxHealthPickups, int particleCapacity = defaultParticleCapacity);
+//same with room for count drones and count pickups, refilled to capacity every tick,
+//that also collide with each other through the sweep-and-prune broadphase
+void InitStressSim(GameSim &sim, const SimAssets &assets, uint64_t seed, int count, int particleCapacity = defaultParticleCapacity);
+//reset run variables before a new attempt
+void ResetGameSim(GameSim &sim, const SimAssets &assets);
+//advance gameplay by dT seconds
+void StepGameSim(GameSim &sim, const SimAssets &assets, SimInput input, float dT);
+//64-bit hash of the simulation state, equal hashes per tick mean identical gameplay
+uint64_t HashGameSim(const GameSim &sim);
+
+//set up the clock for tickRate ticks per second
+void InitSimClock(SimClock &clock, int tickRate);
+//drop any leftover time, e.g. when gameplay (re)starts
+void ResetSimClock(SimClock &clock);
+//add a rendered frame's time and return how many ticks to run for it
+int AdvanceSimClock(SimClock &clock, float frameTime);
+//how far the frame sits between the last two ticks (0..1), for interpolation
+float SimClockAlpha(const SimClock &clock);
+//blend two positions for drawing between ticks
+Vector2 LerpPosition(Vector2 previous, Vector2 current, float alpha);
+
+//checks player on ground
+bool isOnGround(AnimationData data, int windowHeight);
+//checks for collision (player | health pickup)
+bool CheckCollisionPlayerHealthPickup(AnimationData player, Rectangle healthPickup);
+//swept test of box a moving by aMotion against box b moving by bMotion over one tick.
+//On a hit, enter | exit are the fractions of the tick (0..1) the boxes overlap between
+bool SweepRecs(Rectangle a, Vector2 aMotion, Rectangle b, Vector2 bMotion, float &enter, float &exit);
+
+//entity stores, sized once, add returns the new index or -1 when full
+void InitEnemyStore(EnemyStore &enemies, int capacity);
+int AddEnemy(EnemyStore &enemies);
+void RemoveEnemy(EnemyStore &enemies, int index);
+void InitPickupStore(PickupStore &healthPickups, int capacity);
+int AddPickup(PickupStore &healthPickups);
+void RemovePickup(PickupStore &healthPickups, int index);
+
+//entity passes over the live range, exposed so they can be driven at any count
+bool SpawnHealthPickup(PickupStore &healthPickups, const SimAssets &assets, bool onGround);
+//moves pickups and drops the ones that left the screen
+void UpdateHealthPickups(PickupStore &healthPickups, const SimAssets &assets, float dT);
+//add a drone picked from table at the right screen edge
+bool SpawnEnemy(EnemyStore &enemies, const SimAssets &assets, const SpawnTable &table, Rng &rng);
+void UpdateEnemies(EnemyStore &enemies, float dT);
+//tests Mochi against every drone's own hitbox over the tick's motion, all drones in one
+//batched pass, then the pixel masks of the drones whose box was hit along the way
+void CollidePlayerWithEnemies(GameSim &sim, EnemyStore &enemies, const SimAssets &assets);
+//pixel-exact test of Mochi's current frame against drone i's, with both at the
+//point t (0..1) of their motion this tick
+bool PlayerTouchesEnemy(const GameSim &sim, const EnemyStore &enemies, int i, const SimAssets &assets, float t = 1.0f);
+//swept test of Mochi against every health pickup, eats the ones she passed through
+void CollectHealthPickups(GameSim &sim, PickupStore &healthPickups, const SimAssets &assets);
+//stress mode entity | entity collisions: drones that touch both crash, a drone
+//touching a pickup wrecks the pickup
+void CollideEntities(GameSim &sim, const SimAssets &assets);
+
+#endif
@@ -0,0 +1,129 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Sound voice pool
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#include "SoundPool.h"
+#include "Trace.h"
+
+const SoundEffectConfig soundEffects[SOUND_COUNT] = {
+    //jump
+    {2, 0.05f, 1},
+    //impact, drones can hit in quick succession
+    {4, 0.03f, 2},
+    //eat
+    {3, 0.03f, 2},
+    //alarm, once per countdown number
+    {1, 0.05f, 3},
+    //angry, once when "Run!" shows
+    {1, 0.05f, 3},
+    //meow, game over, always heard
+    {1, 1.0f, 4}
+};
+
+//trigger time that never falls inside an interval
+const double neverPlayed = -1.0e9;
+
+void InitSoundPool(SoundPool &pool, const Sound sounds[SOUND_COUNT]) {
+    for (int effect = 0; effect < SOUND_COUNT; effect++) {
+        const Sound &sound = sounds[effect];
+        for (int voice = 0; voice < soundEffects[effect].voices; voice++) {
+            pool.voices[effect][voice] = voice == 0 ? sound : LoadSoundAlias(sound);
+            pool.voiceStart[effect][voice] = 0.0;
+            pool.voiceEnd[effect][voice] = 0.0;
+        }
+        pool.lastPlayed[effect] = neverPlayed;
+        pool.length[effect] = sound.stream.sampleRate > 0 ? (float)sound.frameCount / sound.stream.sampleRate : 0.0f;
+    }
+    pool.loaded = true;
+}
+
+static int CountActiveVoices(const SoundPool &pool, double time) {
+    int active = 0;
+    for (int effect = 0; effect < SOUND_COUNT; effect++) {
+        for (int voice = 0; voice < soundEffects[effect].voices; voice++) {
+            active += pool.voiceEnd[effect][voice] > time;
+        }
+    }
+    return active;
+}
+
+//least important, then oldest, playing voice of another effect that priority may take,
+//false when everything playing matters more
+static bool FindStolenVoice(const SoundPool &pool, SoundId effect, double time, int &stolenEffect, int &stolenVoice) {
+    stolenEffect = -1;
+    for (int other = 0; other < SOUND_COUNT; other++) {
+        if (other == effect || soundEffects[other].priority > soundEffects[effect].priority) {
+            continue;
+        }
+        for (int voice = 0; voice < soundEffects[other].voices; voice++) {
+            if (pool.voiceEnd[other][voice] <= time) {
+                continue;
+            }
+            bool better = stolenEffect < 0 ||
+                          soundEffects[other].priority < soundEffects[stolenEffect].priority ||
+                          (soundEffects[other].priority == soundEffects[stolenEffect].priority &&
+                           pool.voiceStart[other][voice] < pool.voiceStart[stolenEffect][stolenVoice]);
+            if (better) {
+                stolenEffect = other;
+                stolenVoice = voice;
+            }
+        }
+    }
+    return stolenEffect >= 0;
+}
+
+bool PlaySoundEffect(SoundPool &pool, SoundId effect, double time) {
+    const SoundEffectConfig &config = soundEffects[effect];
+    if (!pool.loaded || time - pool.lastPlayed[effect] < config.minInterval) {
+        return false;
+    }
+
+    //a free voice of this effect, else its oldest starts over
+    int voice = -1;
+    int oldest = 0;
+    for (int v = 0; v < config.voices; v++) {
+        if (pool.voiceEnd[effect][v] <= time) {
+            voice = v;
+            break;
+        }
+        if (pool.voiceStart[effect][v] < pool.voiceStart[effect][oldest]) {
+            oldest = v;
+        }
+    }
+    if (voice < 0) {
+        voice = oldest;
+    } else if (CountActiveVoices(pool, time) >= maxActiveVoices) {
+        //one more voice would go over the limit, silence a less important one
+        int stolenEffect;
+        int stolenVoice;
+        if (!FindStolenVoice(pool, effect, time, stolenEffect, stolenVoice)) {
+            return false;
+        }
+        StopSound(pool.voices[stolenEffect][stolenVoice]);
+        pool.voiceEnd[stolenEffect][stolenVoice] = 0.0;
+        TraceInstant("voice stolen", "audio");
+    }
+
+    PlaySound(pool.voices[effect][voice]);
+    pool.voiceStart[effect][voice] = time;
+    pool.voiceEnd[effect][voice] = time + pool.length[effect];
+    pool.lastPlayed[effect] = time;
+    TraceInstant(soundFiles[effect], "audio");
+    return true;
+}
+
+void UnloadSoundPool(SoundPool &pool) {
+    if (!pool.loaded) {
+        return;
+    }
+    for (int effect = 0; effect < SOUND_COUNT; effect++) {
+        for (int voice = 1; voice < soundEffects[effect].voices; voice++) {
+            UnloadSoundAlias(pool.voices[effect][voice]);
+        }
+    }
+    pool.loaded = false;
+}
@@ -0,0 +1,60 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Sound voice pool
+*
+*   Every sound effect gets a few voices (the loaded sound plus aliases sharing its
+*   samples), so overlapping impacts | bites no longer cut each other off. Triggers of
+*   the same effect closer together than its interval are dropped, which keeps bursts
+*   of the same effect in one moment from stacking into a single loud hit. Only so
+*   many voices play at once; past that a new effect takes over the least important,
+*   oldest voice, or is dropped when everything playing matters more.
+*
+*   Voice lengths are tracked here, so picking a voice never asks the audio device.
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#ifndef MOCHI_SOUND_POOL_H
+#define MOCHI_SOUND_POOL_H
+
+#include "raylib.h"
+#include "AssetLoader.h"
+
+//most voices of one effect | playing at once across all effects
+const int maxEffectVoices = 4;
+const int maxActiveVoices = 8;
+
+struct SoundEffectConfig {
+    //voices of this effect, 1..maxEffectVoices
+    int voices;
+    //triggers closer than this after the last one played are dropped (seconds)
+    float minInterval;
+    //higher steals from lower when every voice is busy
+    int priority;
+};
+
+//per effect, indexed by SoundId
+extern const SoundEffectConfig soundEffects[SOUND_COUNT];
+
+struct SoundPool {
+    //voice 0 is the loaded sound, the rest are aliases of it
+    Sound voices[SOUND_COUNT][maxEffectVoices];
+    //when each voice started | runs out, 0 when idle
+    double voiceStart[SOUND_COUNT][maxEffectVoices];
+    double voiceEnd[SOUND_COUNT][maxEffectVoices];
+    //last trigger that played, for the interval
+    double lastPlayed[SOUND_COUNT];
+    //sample length of each effect (seconds)
+    float length[SOUND_COUNT];
+    bool loaded;
+};
+
+//voices for loaded sounds (indexed by SoundId), the sounds stay the caller's
+void InitSoundPool(SoundPool &pool, const Sound sounds[SOUND_COUNT]);
+//play effect at time (GetTime), false when it was dropped
+bool PlaySoundEffect(SoundPool &pool, SoundId effect, double time);
+//unload the aliases, before the sounds themselves
+void UnloadSoundPool(SoundPool &pool);
+
+#endif
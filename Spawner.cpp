@@ -0,0 +1,85 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Spawn scheduler
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#include <algorithm>
+#include "Spawner.h"
+
+//drone 1-3, on the ground or slightly above
+const SpawnTable defaultGroundSpawns = {
+    2.0f, 8.0f,
+    3,
+    {
+        {0, 1, 400, 800, 2, {{0.0f, 1.0f}, {45.0f, 1.0f}}},
+        {1, 1, 400, 800, 2, {{0.0f, 1.0f}, {45.0f, 1.0f}}},
+        {2, 1, 400, 800, 2, {{0.0f, 1.0f}, {45.0f, 1.0f}}},
+    }
+};
+
+//drone 4, centered 145 px over the ground
+const SpawnTable defaultAirSpawns = {
+    8.0f, 12.0f,
+    1,
+    {
+        {3, 1, 200, 300, 1, {{145.0f, 0.5f}}},
+    }
+};
+
+//heap order, earliest first (ties by kind so the order never depends on the heap)
+static bool SpawnLater(const SpawnEvent &a, const SpawnEvent &b) {
+    if (a.time != b.time) {
+        return a.time > b.time;
+    }
+    return a.kind > b.kind;
+}
+
+void InitSpawnScheduler(SpawnScheduler &spawns) {
+    spawns.now = 0.0;
+    spawns.count = 0;
+}
+
+bool ScheduleSpawn(SpawnScheduler &spawns, SpawnKind kind, double time) {
+    if (spawns.count >= maxSpawnEvents) {
+        return false;
+    }
+    spawns.events[spawns.count++] = (SpawnEvent){time, kind};
+    std::push_heap(spawns.events, spawns.events + spawns.count, SpawnLater);
+    return true;
+}
+
+void AdvanceSpawnScheduler(SpawnScheduler &spawns, float dT) {
+    spawns.now += dT;
+}
+
+bool PopDueSpawn(SpawnScheduler &spawns, SpawnKind &kind) {
+    if (spawns.count == 0 || spawns.events[0].time > spawns.now) {
+        return false;
+    }
+    kind = spawns.events[0].kind;
+    std::pop_heap(spawns.events, spawns.events + spawns.count, SpawnLater);
+    spawns.count--;
+    return true;
+}
+
+float DrawSpawnInterval(const SpawnTable &table, Rng &rng) {
+    return RngFloat(rng, table.minInterval, table.maxInterval);
+}
+
+const SpawnEntry &PickSpawnEntry(const SpawnTable &table, Rng &rng) {
+    int totalWeight = 0;
+    for (int i = 0; i < table.entryCount; i++) {
+        totalWeight += table.entries[i].weight;
+    }
+    int pick = RngRange(rng, 0, totalWeight - 1);
+    for (int i = 0; i < table.entryCount; i++) {
+        pick -= table.entries[i].weight;
+        if (pick < 0) {
+            return table.entries[i];
+        }
+    }
+    return table.entries[table.entryCount - 1];
+}
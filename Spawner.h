@@ -0,0 +1,94 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Spawn scheduler
+*
+*   Upcoming spawns as timed events in a small priority queue. The time of the next spawn
+*   of a kind is drawn once, when the previous one happens, so a tick with nothing due
+*   costs one comparison. What a drone spawn creates comes from a spawn table (drone type
+*   weights, speed ranges, heights) instead of constants in the spawn code.
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#ifndef MOCHI_SPAWNER_H
+#define MOCHI_SPAWNER_H
+
+#include "Random.h"
+
+//what a spawn event creates
+enum SpawnKind {
+    SPAWN_GROUND_DRONE,
+    SPAWN_AIR_DRONE,
+    SPAWN_HEALTH,
+    SPAWN_KIND_COUNT
+};
+
+//table limits
+const int maxSpawnHeights = 4;
+const int maxSpawnEntries = 8;
+//queued events, one per kind plus retries
+const int maxSpawnEvents = 8;
+
+//spawn height, y = screenHeight - aboveGround - sprite height * anchor
+//(anchor 1 puts the sprite's bottom aboveGround px over the ground, 0.5 its middle)
+struct SpawnHeight {
+    float aboveGround;
+    float anchor;
+};
+
+//one drone type a table can pick
+struct SpawnEntry {
+    //index into SimAssets::drones
+    int droneType;
+    //relative chance against the table's other entries
+    int weight;
+    //px/s, both inclusive
+    int minSpeed;
+    int maxSpeed;
+    //picked with equal chance
+    int heightCount;
+    SpawnHeight heights[maxSpawnHeights];
+};
+
+//drone spawns of one kind
+struct SpawnTable {
+    //seconds from one spawn to the next
+    float minInterval;
+    float maxInterval;
+    int entryCount;
+    SpawnEntry entries[maxSpawnEntries];
+};
+
+//built in tables
+extern const SpawnTable defaultGroundSpawns;
+extern const SpawnTable defaultAirSpawns;
+
+struct SpawnEvent {
+    double time;
+    SpawnKind kind;
+};
+
+struct SpawnScheduler {
+    //seconds the scheduler has run
+    double now;
+    //min-heap on time
+    int count;
+    SpawnEvent events[maxSpawnEvents];
+};
+
+//empty queue at time 0
+void InitSpawnScheduler(SpawnScheduler &spawns);
+//queue a spawn of kind at time, false when the queue is full
+bool ScheduleSpawn(SpawnScheduler &spawns, SpawnKind kind, double time);
+//move the clock forward by dT
+void AdvanceSpawnScheduler(SpawnScheduler &spawns, float dT);
+//take the earliest event that is due by now, false when none is
+bool PopDueSpawn(SpawnScheduler &spawns, SpawnKind &kind);
+
+//seconds until the next spawn of table, drawn from its interval
+float DrawSpawnInterval(const SpawnTable &table, Rng &rng);
+//weighted pick of one of table's entries
+const SpawnEntry &PickSpawnEntry(const SpawnTable &table, Rng &rng);
+
+#endif
@@ -0,0 +1,199 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Trace export
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Trace.h"
+
+//one recorded event, times in microseconds since the trace was opened
+struct TraceEvent {
+    const char *name;
+    const char *category;
+    char type;
+    double start;
+    double duration;
+    //track of the recording thread, 1 for the first one (the main thread)
+    int thread;
+};
+
+//events are recorded into fixed chunks, full chunks go to the writer thread
+const int traceChunkSize = 16384;
+
+struct TraceChunk {
+    TraceEvent events[traceChunkSize];
+    int count;
+};
+
+struct TraceState {
+    bool enabled;
+    bool csv;
+    bool firstEvent;
+    FILE *file;
+    TraceClock::time_point origin;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    TraceChunk *current;
+    std::vector<TraceChunk *> fullChunks;
+    std::vector<TraceChunk *> freeChunks;
+    std::thread writer;
+    bool stopping;
+};
+
+static TraceState trace;
+
+//numbered on their first event, so worker threads get their own track
+static std::atomic<int> traceThreadCount(0);
+static thread_local int traceThread = 0;
+
+static int TraceThread() {
+    if (traceThread == 0) {
+        traceThread = ++traceThreadCount;
+    }
+    return traceThread;
+}
+
+static double MicrosecondsSinceOrigin(TraceClock::time_point time) {
+    return std::chrono::duration<double, std::micro>(time - trace.origin).count();
+}
+
+//format one chunk, runs on the writer thread only
+static void WriteTraceChunk(const TraceChunk *chunk) {
+    for (int i = 0; i < chunk->count; i++) {
+        const TraceEvent &event = chunk->events[i];
+        if (trace.csv) {
+            fprintf(trace.file, "%.3f,%.3f,%c,%s,%s\n", event.start, event.duration, event.type, event.category, event.name);
+            continue;
+        }
+
+        fprintf(trace.file, "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,", trace.firstEvent ? "" : ",", event.name, event.category, event.type, event.start);
+        if (event.type == 'X') {
+            fprintf(trace.file, "\"dur\":%.3f,", event.duration);
+        } else {
+            fprintf(trace.file, "\"s\":\"g\",");
+        }
+        fprintf(trace.file, "\"pid\":1,\"tid\":%d}", event.thread);
+        trace.firstEvent = false;
+    }
+}
+
+static void TraceWriterThread() {
+    std::unique_lock<std::mutex> lock(trace.mutex);
+    while (true) {
+        trace.wake.wait(lock, [] { return trace.stopping || !trace.fullChunks.empty(); });
+        if (trace.fullChunks.empty() && trace.stopping) {
+            break;
+        }
+
+        TraceChunk *chunk = trace.fullChunks.front();
+        trace.fullChunks.erase(trace.fullChunks.begin());
+
+        //file output happens without holding the lock
+        lock.unlock();
+        WriteTraceChunk(chunk);
+        lock.lock();
+
+        chunk->count = 0;
+        trace.freeChunks.push_back(chunk);
+    }
+}
+
+static TraceChunk *TakeFreeChunk() {
+    if (trace.freeChunks.empty()) {
+        TraceChunk *chunk = new TraceChunk;
+        chunk->count = 0;
+        return chunk;
+    }
+    TraceChunk *chunk = trace.freeChunks.back();
+    trace.freeChunks.pop_back();
+    return chunk;
+}
+
+static void PushTraceEvent(const TraceEvent &event) {
+    std::lock_guard<std::mutex> lock(trace.mutex);
+    trace.current->events[trace.current->count++] = event;
+
+    //hand a full chunk over instead of writing on the hot path
+    if (trace.current->count == traceChunkSize) {
+        trace.fullChunks.push_back(trace.current);
+        trace.current = TakeFreeChunk();
+        trace.wake.notify_one();
+    }
+}
+
+bool OpenTrace(const char *fileName) {
+    trace.file = fopen(fileName, "w");
+    if (!trace.file) {
+        return false;
+    }
+    const char *extension = strrchr(fileName, '.');
+    trace.csv = extension && strcmp(extension, ".csv") == 0;
+    trace.firstEvent = true;
+    trace.origin = TraceClock::now();
+    trace.stopping = false;
+    trace.current = TakeFreeChunk();
+
+    if (trace.csv) {
+        fprintf(trace.file, "start_us,duration_us,type,category,name\n");
+    } else {
+        fprintf(trace.file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    }
+
+    trace.writer = std::thread(TraceWriterThread);
+    trace.enabled = true;
+    return true;
+}
+
+void CloseTrace() {
+    if (!trace.enabled) {
+        return;
+    }
+    trace.enabled = false;
+
+    {
+        std::lock_guard<std::mutex> lock(trace.mutex);
+        trace.fullChunks.push_back(trace.current);
+        trace.current = nullptr;
+        trace.stopping = true;
+    }
+    trace.wake.notify_one();
+    trace.writer.join();
+
+    if (!trace.csv) {
+        fprintf(trace.file, "\n]}\n");
+    }
+    fclose(trace.file);
+    trace.file = nullptr;
+
+    for (TraceChunk *chunk : trace.freeChunks) {
+        delete chunk;
+    }
+    trace.freeChunks.clear();
+}
+
+bool IsTraceEnabled() {
+    return trace.enabled;
+}
+
+void TraceComplete(const char *name, const char *category, TraceClock::time_point start, TraceClock::time_point end) {
+    if (!trace.enabled) return;
+
+    double startUs = MicrosecondsSinceOrigin(start);
+    PushTraceEvent({name, category, 'X', startUs, MicrosecondsSinceOrigin(end) - startUs, TraceThread()});
+}
+
+void TraceInstant(const char *name, const char *category) {
+    if (!trace.enabled) return;
+
+    PushTraceEvent({name, category, 'i', MicrosecondsSinceOrigin(TraceClock::now()), 0.0, TraceThread()});
+}
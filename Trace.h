@@ -0,0 +1,31 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Trace export
+*
+*   Scoped timing events (frames, update phases, asset loads, state transitions) buffered
+*   in memory and written by a background thread as Chrome trace-event JSON
+*   (chrome://tracing, ui.perfetto.dev) or, for a .csv file name, as CSV rows.
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#ifndef MOCHI_TRACE_H
+#define MOCHI_TRACE_H
+
+#include <chrono>
+
+typedef std::chrono::steady_clock TraceClock;
+
+//start tracing to fileName, returns false if it cannot be created
+bool OpenTrace(const char *fileName);
+//flush everything still buffered and finish the file
+void CloseTrace();
+bool IsTraceEnabled();
+
+//event with a duration, name and category must outlive the trace (string literals)
+void TraceComplete(const char *name, const char *category, TraceClock::time_point start, TraceClock::time_point end);
+//point in time event, e.g. a state transition or a spawn
+void TraceInstant(const char *name, const char *category);
+
+#endif
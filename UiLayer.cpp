@@ -0,0 +1,44 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Cached UI layers
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#include "UiLayer.h"
+#include "Trace.h"
+
+void LoadUiLayer(UiLayer &layer, int width, int height) {
+    layer.target = LoadRenderTexture(width, height);
+    layer.key = 0;
+    layer.built = false;
+}
+
+void UnloadUiLayer(UiLayer &layer) {
+    UnloadRenderTexture(layer.target);
+    layer.built = false;
+}
+
+bool UiLayerNeedsBuild(const UiLayer &layer, long long key) {
+    return !layer.built || layer.key != key;
+}
+
+void BeginUiLayer(UiLayer &layer, long long key) {
+    TraceInstant("ui layer build", "ui");
+    layer.key = key;
+    layer.built = true;
+    BeginTextureMode(layer.target);
+    ClearBackground(BLANK);
+}
+
+void EndUiLayer() {
+    EndTextureMode();
+}
+
+void DrawUiLayer(const UiLayer &layer, int x, int y, Color tint) {
+    const Texture2D &texture = layer.target.texture;
+    //render textures are stored bottom up, flip the source
+    Rectangle source = {0, 0, (float)texture.width, -(float)texture.height};
+    DrawTextureRec(texture, source, (Vector2){(float)x, (float)y}, tint);
+}
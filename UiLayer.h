@@ -0,0 +1,38 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Cached UI layers
+*
+*   Static screen text rendered once into a render texture and composited with a single
+*   draw. A layer is rebuilt only when its key (whatever the text depends on) changes.
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#ifndef MOCHI_UI_LAYER_H
+#define MOCHI_UI_LAYER_H
+
+#include "raylib.h"
+
+struct UiLayer {
+    RenderTexture2D target;
+    //what the current contents were built from
+    long long key;
+    bool built;
+};
+
+void LoadUiLayer(UiLayer &layer, int width, int height);
+void UnloadUiLayer(UiLayer &layer);
+
+//true when the contents are missing or were built for another key
+bool UiLayerNeedsBuild(const UiLayer &layer, long long key);
+
+//draws in between go into the layer, cleared to transparent first.
+//switching targets flushes raylib's batch, so build before anything else is drawn that frame
+void BeginUiLayer(UiLayer &layer, long long key);
+void EndUiLayer();
+
+//composite the layer with its top left at x, y
+void DrawUiLayer(const UiLayer &layer, int x, int y, Color tint);
+
+#endif
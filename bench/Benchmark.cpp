@@ -0,0 +1,304 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Benchmarks
+*
+*   Times the simulation hot loops at entity counts from the game's 10 up to 100k.
+*   Run from the repository root (sprite sizes are read from textures/):
+*
+*       make bench && ./game_bench [name filter]
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "raylib.h"
+#include "Headless.h"
+#include "SimdKernels.h"
+#include "Simulation.h"
+
+typedef std::chrono::steady_clock BenchClock;
+
+//timing settings
+const double warmupSeconds = 0.05;
+const double sampleSeconds = 0.01;
+const int sampleCount = 15;
+
+//entity counts every benchmark runs at
+const int benchCounts[] = {10, 100, 1000, 10000, 100000};
+
+//stops the compiler from dropping work whose result is unused
+static volatile int benchSink;
+
+static double SecondsSince(BenchClock::time_point start) {
+    return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+//one benchmark: prepare (untimed) then run once per call, touching count entities (the
+//timings are divided by count)
+struct Benchmark {
+    const char *name;
+    void (*prepare)(int count);
+    void (*run)(int count);
+    //entity kernels to use
+    SimdLevel simd;
+};
+
+//run a benchmark at count entities and print median | min ns per entity op
+static void RunBenchmark(const Benchmark &bench, int count) {
+    SetSimdLevel(bench.simd);
+    bench.prepare(count);
+
+    //warmup, also calibrates how many runs fill one sample
+    long long runs = 0;
+    BenchClock::time_point start = BenchClock::now();
+    while (SecondsSince(start) < warmupSeconds) {
+        bench.run(count);
+        runs++;
+    }
+    long long runsPerSample = std::max(1LL, (long long)(runs * sampleSeconds / warmupSeconds));
+
+    std::vector<double> samples;
+    for (int sample = 0; sample < sampleCount; sample++) {
+        bench.prepare(count);
+        start = BenchClock::now();
+        for (long long i = 0; i < runsPerSample; i++) {
+            bench.run(count);
+        }
+        double seconds = SecondsSince(start);
+        samples.push_back(seconds * 1e9 / ((double)runsPerSample * count));
+    }
+    std::sort(samples.begin(), samples.end());
+
+    double median = samples[samples.size() / 2];
+    double best = samples.front();
+    printf("%-32s %8d %12.2f %12.2f %14.1f\n", bench.name, count, median, best, 1e3 / median);
+}
+
+//shared state
+static SimAssets assets;
+static GameSim sim;
+static Animator animations;
+static PickupStore pickups;
+static EnemyStore enemies;
+static const float benchDt = 1.0f / 120.0f;
+
+//AdvanceAnimations, one animation per entity, every mode and staggered timers
+static void PrepareAnimations(int count) {
+    InitAnimator(animations, count);
+    for (int i = 0; i < count; i++) {
+        int index = AddAnimation(animations);
+        AnimationClip clip = assets.drones[i % droneTypeCount].clip;
+        clip.mode = (AnimationMode)(i % 3);
+        PlayAnimation(animations, index, clip);
+        animations.timer[index] = (i % 8) * benchDt;
+    }
+}
+
+static void RunAnimations(int) {
+    AdvanceAnimations(animations, benchDt);
+}
+
+//CheckCollisionPlayerHealthPickup, Mochi against every pickup (a few overlap)
+static void PreparePickups(int count) {
+    InitPickupStore(pickups, count);
+    for (int i = 0; i < count; i++) {
+        int index = AddPickup(pickups);
+        pickups.x[index] = (float)(i % assets.screenWidth);
+        pickups.y[index] = (float)(assets.screenHeight - 26);
+        pickups.speed[index] = 200;
+    }
+}
+
+static void RunPickupCollision(int count) {
+    const float width = (float)assets.healthPickupTexture.width;
+    const float height = (float)assets.healthPickupTexture.height;
+    int hits = 0;
+    for (int i = 0; i < count; i++) {
+        hits += CheckCollisionPlayerHealthPickup(sim.mochiData, (Rectangle){pickups.x[i], pickups.y[i], width, height});
+    }
+    benchSink = hits;
+}
+
+//enemy update | animation loop, drones far to the right so none despawn mid-sample
+static void PrepareEnemies(int count) {
+    Rng rng;
+    RngSeed(rng, 1);
+    InitEnemyStore(enemies, count);
+    for (int i = 0; i < count; i++) {
+        int index = AddEnemy(enemies);
+        const Drone &drone = assets.drones[i % droneTypeCount];
+        enemies.type[index] = i % droneTypeCount;
+        enemies.width[index] = (float)drone.texture.width;
+        const Rectangle &hitbox = assets.droneCollisionRectangles[i % droneTypeCount];
+        enemies.hitX[index] = hitbox.x;
+        enemies.hitY[index] = hitbox.y;
+        enemies.hitWidth[index] = hitbox.width;
+        enemies.hitHeight[index] = hitbox.height;
+        PlayAnimation(enemies.animation, index, drone.clip);
+        enemies.animation.timer[index] = RngRange(rng, 0, 9) * 0.01f;
+        enemies.x[index] = 1.0e7f;
+        enemies.y[index] = (float)RngRange(rng, 100, 250);
+        enemies.speed[index] = RngRange(rng, 400, 800);
+        enemies.prevX[index] = enemies.x[index];
+        enemies.prevY[index] = enemies.y[index];
+    }
+}
+
+static void RunEnemyUpdate(int) {
+    UpdateEnemies(enemies, benchDt);
+}
+
+//table driven drone spawn into a store with one free slot, removed again after each spawn,
+//count of them a run so the timing divided by count is per spawn
+static void PrepareSpawn(int count) {
+    PrepareEnemies(count);
+    RemoveEnemy(enemies, count - 1);
+}
+
+static void RunSpawn(int count) {
+    for (int i = 0; i < count; i++) {
+        SpawnEnemy(enemies, assets, assets.groundSpawns, sim.rng);
+        RemoveEnemy(enemies, count - 1);
+    }
+}
+
+//player vs enemy collision loop, no drone touches Mochi so state stays put
+static void PrepareCollision(int count) {
+    PrepareEnemies(count);
+    for (int i = 0; i < count; i++) {
+        enemies.x[i] = 300.0f + (i % 400);
+        enemies.prevX[i] = enemies.x[i] + enemies.speed[i] * benchDt;
+    }
+}
+
+static void RunCollision(int) {
+    CollidePlayerWithEnemies(sim, enemies, assets);
+}
+
+//narrow phase alone, Mochi against drones placed all around her so every box overlaps
+static void PrepareMaskCollision(int count) {
+    PrepareEnemies(count);
+    for (int i = 0; i < count; i++) {
+        enemies.x[i] = sim.mochiData.pos.x - 40.0f + (i % 80);
+        enemies.y[i] = sim.mochiData.pos.y - 30.0f + (i % 7) * 10.0f;
+        enemies.animation.frame[i] = i % enemies.animation.frameCount[i];
+        enemies.prevX[i] = enemies.x[i];
+        enemies.prevY[i] = enemies.y[i];
+    }
+}
+
+static void RunMaskCollision(int count) {
+    int hits = 0;
+    for (int i = 0; i < count; i++) {
+        hits += PlayerTouchesEnemy(sim, enemies, i, assets);
+    }
+    benchSink = hits;
+}
+
+//stress mode broadphase, drones | pickups spread over the stress lane, moved a tick
+//before each update so the order has to be repaired like in the game
+static SweepAndPrune broadphase;
+
+static void PrepareBroadphase(int count) {
+    PrepareEnemies(count);
+    PreparePickups(count);
+    Rng rng;
+    RngSeed(rng, 2);
+    const int lane = (int)(count * stressSpacing);
+    for (int i = 0; i < count; i++) {
+        enemies.x[i] = (float)RngRange(rng, 0, lane);
+        enemies.y[i] = (float)RngRange(rng, 0, assets.screenHeight - 96);
+        enemies.broadphaseSlot[i] = -1;
+        pickups.x[i] = (float)RngRange(rng, 0, lane);
+        pickups.y[i] = (float)RngRange(rng, 0, assets.screenHeight - 16);
+        pickups.broadphaseSlot[i] = -1;
+    }
+    ResetSweepAndPrune(broadphase);
+}
+
+static void RunBroadphase(int count) {
+    //moving back right once past the lane start keeps the layout steady between samples
+    AdvancePositions(enemies.x.data(), enemies.speed.data(), count, benchDt);
+    AdvancePositions(pickups.x.data(), pickups.speed.data(), count, benchDt);
+    for (int i = 0; i < count; i++) {
+        if (enemies.x[i] < 0.0f) enemies.x[i] += count * stressSpacing;
+        if (pickups.x[i] < 0.0f) pickups.x[i] += count * stressSpacing;
+    }
+
+    BroadphaseGroup groups[2] = {};
+    groups[0].count = count;
+    groups[0].x = enemies.x.data();
+    groups[0].y = enemies.y.data();
+    groups[0].boxX = enemies.hitX.data();
+    groups[0].boxY = enemies.hitY.data();
+    groups[0].width = enemies.hitWidth.data();
+    groups[0].height = enemies.hitHeight.data();
+    groups[0].slot = enemies.broadphaseSlot.data();
+    groups[1].count = count;
+    groups[1].x = pickups.x.data();
+    groups[1].y = pickups.y.data();
+    groups[1].uniformWidth = (float)assets.healthPickupTexture.width;
+    groups[1].uniformHeight = (float)assets.healthPickupTexture.height;
+    groups[1].slot = pickups.broadphaseSlot.data();
+    UpdateSweepAndPrune(broadphase, groups, 2);
+    benchSink = (int)broadphase.pairs.size();
+}
+
+//particle update, the pool filled with sparks that outlive the samples
+static ParticleStore particles;
+
+static void PrepareParticles(int count) {
+    Rng rng;
+    RngSeed(rng, 3);
+    InitParticleStore(particles, count);
+    while (particles.count < count) {
+        EmitParticles(particles, PARTICLE_SPARK, (Vector2){350.0f, 150.0f}, rng);
+    }
+    for (int i = 0; i < count; i++) {
+        particles.life[i] = 1.0e6f;
+    }
+}
+
+static void RunParticles(int) {
+    UpdateParticles(particles, benchDt);
+}
+
+int main(int argc, char *argv[]) {
+    const char *filter = argc > 1 ? argv[1] : nullptr;
+
+    SetTraceLogLevel(LOG_WARNING);
+    InitSimAssets(assets, 700, 300, LoadTextureSize);
+    InitGameSim(sim, assets, 1);
+
+    const SimdLevel best = DetectSimdLevel();
+    const Benchmark benchmarks[] = {
+        {"AdvanceAnimations", PrepareAnimations, RunAnimations, best},
+        {"CheckCollisionPlayerPickup", PreparePickups, RunPickupCollision, best},
+        {"UpdateEnemies", PrepareEnemies, RunEnemyUpdate, best},
+        {"UpdateEnemies/scalar", PrepareEnemies, RunEnemyUpdate, SIMD_SCALAR},
+        {"UpdateEnemies/sse2", PrepareEnemies, RunEnemyUpdate, SIMD_SSE2},
+        {"SpawnEnemy", PrepareSpawn, RunSpawn, best},
+        {"CollidePlayerWithEnemies", PrepareCollision, RunCollision, best},
+        {"CollidePlayerWithEnemies/scalar", PrepareCollision, RunCollision, SIMD_SCALAR},
+        {"PlayerTouchesEnemy", PrepareMaskCollision, RunMaskCollision, best},
+        {"UpdateSweepAndPrune", PrepareBroadphase, RunBroadphase, best},
+        {"UpdateParticles", PrepareParticles, RunParticles, best},
+        {"UpdateParticles/scalar", PrepareParticles, RunParticles, SIMD_SCALAR},
+    };
+
+    printf("%-32s %8s %12s %12s %14s\n", "benchmark", "count", "median ns", "min ns", "Mentities/s");
+    for (const Benchmark &bench : benchmarks) {
+        if (filter && !strstr(bench.name, filter)) {
+            continue;
+        }
+        for (int count : benchCounts) {
+            RunBenchmark(bench, count);
+        }
+    }
+    return 0;
+}
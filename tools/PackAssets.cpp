@@ -0,0 +1,190 @@
+/*******************************************************************************************
+*
+*   Mochi, Run - Asset pack baker
+*
+*   Decodes every sprite sheet and sound effect the game loads, packs the texture atlas
+*   and writes them all, with the music files as they are, into assets.pak (see
+*   AssetPack.h). Run it from the game directory: `make pack`, again after changing any
+*   texture or sound (the game ignores a stale pack and says so).
+*
+*   @copyright (c) 2023 by Franz Lor, all rights reserved
+*
+********************************************************************************************/
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "raylib.h"
+#include "AssetLoader.h"
+#include "AssetPack.h"
+#include "Atlas.h"
+
+//one entry plus the bytes it points at (none for sources)
+struct PackItem {
+    AssetPackEntry entry;
+    const void *data;
+};
+
+static AssetPackEntry PackEntry(const char *name, AssetPackKind kind) {
+    AssetPackEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    strncpy(entry.name, name, sizeof(entry.name) - 1);
+    entry.kind = kind;
+    return entry;
+}
+
+//the loose file as it is now, checked by the game on every start
+static void AddSource(std::vector<PackItem> &items, const char *fileName) {
+    AssetPackEntry entry = PackEntry(fileName, PACK_SOURCE);
+    entry.sourceTime = GetFileModTime(fileName);
+    entry.sourceSize = GetFileLength(fileName);
+    items.push_back({entry, nullptr});
+}
+
+static void AddImage(std::vector<PackItem> &items, const char *name, const Image &image) {
+    AssetPackEntry entry = PackEntry(name, PACK_IMAGE);
+    entry.params[0] = image.width;
+    entry.params[1] = image.height;
+    entry.size = (uint64_t)image.width * image.height * 4;
+    items.push_back({entry, image.data});
+}
+
+static void AddWave(std::vector<PackItem> &items, const char *name, const Wave &wave) {
+    AssetPackEntry entry = PackEntry(name, PACK_WAVE);
+    entry.params[0] = wave.frameCount;
+    entry.params[1] = wave.sampleRate;
+    entry.params[2] = wave.sampleSize;
+    entry.params[3] = wave.channels;
+    entry.size = (uint64_t)wave.frameCount * wave.channels * (wave.sampleSize / 8);
+    items.push_back({entry, wave.data});
+}
+
+static void AddBlob(std::vector<PackItem> &items, const char *name, const void *data, uint64_t size) {
+    AssetPackEntry entry = PackEntry(name, PACK_BLOB);
+    entry.size = size;
+    items.push_back({entry, data});
+}
+
+static uint64_t AlignPackOffset(uint64_t offset) {
+    return (offset + assetPackAlignment - 1) / assetPackAlignment * assetPackAlignment;
+}
+
+//header, index, then every entry's data on an aligned offset
+static bool WriteAssetPack(const char *fileName, std::vector<PackItem> &items) {
+    uint64_t offset = sizeof(AssetPackHeader) + sizeof(AssetPackEntry) * items.size();
+    for (PackItem &item : items) {
+        if (item.entry.kind != PACK_SOURCE) {
+            offset = AlignPackOffset(offset);
+            item.entry.offset = offset;
+            offset += item.entry.size;
+        }
+    }
+
+    FILE *file = fopen(fileName, "wb");
+    if (!file) {
+        return false;
+    }
+    AssetPackHeader header;
+    memcpy(header.magic, assetPackMagic, sizeof(header.magic));
+    header.version = assetPackVersion;
+    header.entryCount = (uint32_t)items.size();
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (const PackItem &item : items) {
+        written = written && fwrite(&item.entry, sizeof(item.entry), 1, file) == 1;
+    }
+
+    const char zeros[assetPackAlignment] = {0};
+    uint64_t position = sizeof(AssetPackHeader) + sizeof(AssetPackEntry) * items.size();
+    for (const PackItem &item : items) {
+        if (item.entry.kind == PACK_SOURCE) {
+            continue;
+        }
+        written = written && fwrite(zeros, 1, item.entry.offset - position, file) == item.entry.offset - position;
+        written = written && (item.entry.size == 0 || fwrite(item.data, 1, item.entry.size, file) == item.entry.size);
+        position = item.entry.offset + item.entry.size;
+    }
+    return fclose(file) == 0 && written;
+}
+
+int main() {
+    SetTraceLogLevel(LOG_WARNING);
+    std::vector<PackItem> items;
+
+    //sprites, RGBA like the atlas so masks read them without converting
+    Image images[SPRITE_COUNT];
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        images[i] = LoadImage(spriteFiles[i]);
+        if (images[i].data == nullptr) {
+            fprintf(stderr, "PackAssets: cannot load %s (run from the game directory)\n", spriteFiles[i]);
+            return 1;
+        }
+        ImageFormat(&images[i], PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        AddSource(items, spriteFiles[i]);
+        AddImage(items, spriteFiles[i], images[i]);
+    }
+
+    //the atlas the game would pack at startup, rectangles then the white block
+    TextureAtlas atlas = {};
+    Image atlasImage = BakeTextureAtlas(atlas, images);
+    if (atlasImage.data == nullptr) {
+        fprintf(stderr, "PackAssets: cannot pack the atlas\n");
+        return 1;
+    }
+    Rectangle atlasRects[SPRITE_COUNT + 1];
+    memcpy(atlasRects, atlas.sprites, sizeof(atlas.sprites));
+    atlasRects[SPRITE_COUNT] = atlas.solid;
+    AddImage(items, packAtlasImage, atlasImage);
+    AddBlob(items, packAtlasSprites, atlasRects, sizeof(atlasRects));
+
+    //sound effects as PCM, raylib converts to the device format on upload
+    Wave waves[SOUND_COUNT];
+    for (int i = 0; i < SOUND_COUNT; i++) {
+        waves[i] = LoadWave(soundFiles[i]);
+        if (waves[i].data == nullptr) {
+            fprintf(stderr, "PackAssets: cannot load %s\n", soundFiles[i]);
+            return 1;
+        }
+        AddSource(items, soundFiles[i]);
+        AddWave(items, soundFiles[i], waves[i]);
+    }
+
+    //music is streamed, so it stays compressed
+    unsigned char *music[MUSIC_COUNT];
+    for (int i = 0; i < MUSIC_COUNT; i++) {
+        int size = 0;
+        music[i] = LoadFileData(musicFiles[i], &size);
+        if (music[i] == nullptr) {
+            fprintf(stderr, "PackAssets: cannot load %s\n", musicFiles[i]);
+            return 1;
+        }
+        AddSource(items, musicFiles[i]);
+        AddBlob(items, musicFiles[i], music[i], size);
+    }
+
+    bool written = WriteAssetPack(assetPackFile, items);
+
+    for (int i = 0; i < SPRITE_COUNT; i++) {
+        UnloadImage(images[i]);
+    }
+    UnloadImage(atlasImage);
+    for (int i = 0; i < SOUND_COUNT; i++) {
+        UnloadWave(waves[i]);
+    }
+    for (int i = 0; i < MUSIC_COUNT; i++) {
+        UnloadFileData(music[i]);
+    }
+    if (!written) {
+        fprintf(stderr, "PackAssets: cannot write %s\n", assetPackFile);
+        return 1;
+    }
+
+    //read it back the way the game does
+    AssetPack pack;
+    if (!OpenAssetPack(pack, assetPackFile) || !AssetPackComplete(pack)) {
+        fprintf(stderr, "PackAssets: %s does not read back\n", assetPackFile);
+        return 1;
+    }
+    printf("PackAssets: %s, %d entries, %.1f MB\n", assetPackFile, pack.entryCount, pack.file.size / (1024.0 * 1024.0));
+    CloseAssetPack(pack);
+    return 0;
+}